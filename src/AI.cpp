@@ -27,14 +27,6 @@
 #include <iomanip>
 #include <optional>
 
-int AI::s_rounds = 0;
-int AI::count_visited = 0;
-
-uint64_t AI::vs_lookups = 0;
-uint64_t AI::vs_hits = 0;
-uint64_t AI::vs_inserts = 0;
-
-
 //para debug tree
 static inline std::string indent_rails(int depth) {
     std::string p;
@@ -45,11 +37,6 @@ static inline std::string branch_prefix(int depth, bool last) {
     return indent_rails(depth) + (last ? "└── " : "├── ");
 }
 
-namespace {
-    static std::unordered_map<CompactOrderKey, std::vector<MoveScore>> s_order_cache;
-    static std::unordered_map<CompactHeuristicKey, int> s_heuristic_cache;
-}
-
 CompactStateKey AI::compact_state_key(const Board& board, bool is_max, int player_search) const {
     CompactStateKey ck;
     auto mk = board.get_marker();
@@ -63,16 +50,179 @@ CompactStateKey AI::compact_state_key(const Board& board, bool is_max, int playe
 
 // Limpa as caches locais
 void AI::clear_order_caches() {
-    s_order_cache.clear();
+    ctx->order_cache.clear();
 }
 
 void AI::clear_s_heuristic_caches() {
-    s_heuristic_cache.clear();
+    ctx->heuristic_cache.clear();
 }
 
 void AI::clear_tt() {
+    region_solver.clear();
     tt.clear();
     tt.rehash(0);
+    qtt.clear();
+    qtt.rehash(0);
+    wl_tt.clear();
+    wl_tt.rehash(0);
+}
+
+// Solver exato (df-pn) com TT própria; não interfere com a TT do minimax
+ProofNumberSolver::Verdict AI::solve(const Board& board, uint64_t node_budget) {
+    auto v = pn_solver.solve(board, node_budget);
+    if (debug_level >= 1) {
+        const char* res = v.result == ProofNumberSolver::Result::Win  ? "WIN"
+                        : v.result == ProofNumberSolver::Result::Loss ? "LOSS" : "UNKNOWN";
+        LogMsgs::out() << "[solve] " << res << " move=(" << v.move.first << ","
+                       << v.move.second << ") nodes=" << v.nodes << "\n";
+    }
+    return v;
+}
+
+// Modo vitória/derrota: cada iteração aumenta o horizonte e decide o valor
+// {-1000, 0, 1000} com testes de janela nula (MTD(f)), reaproveitando os
+// limites da wl_tt entre testes e iterações. Acaba quando o valor deixa de ser
+// 0 ou o horizonte cobre todas as casas alcançáveis (todas as linhas terminam).
+ProofNumberSolver::Verdict AI::solve_wl(const Board& board, uint64_t node_budget) {
+    ProofNumberSolver::Verdict v;
+    Board b = board;
+    const bool mover_max = b.current_player_is_max();
+    aborted = false;
+    wl_nodes = 0;
+    wl_budget = node_budget;
+
+    const int horizon = b.compute_distance().reachable_count + 1;
+    int g = 0;
+    for (int d = 1; d <= horizon && g == 0 && !aborted; ++d) {
+        int lower = -1000, upper = 1000;
+        while (lower < upper) {
+            const int beta = (g == lower) ? g + 1 : g;
+            g = wl_search(b, mover_max, /*depth=*/0, beta - 1, beta, d);
+            if (aborted) break;
+            if (g < beta) upper = g; else lower = g;
+        }
+        if (debug_level >= 2 && !aborted) {
+            LogMsgs::out() << "[solve-wl] d=" << d << " value=" << g << " nodes=" << wl_nodes << "\n";
+        }
+    }
+
+    v.nodes = wl_nodes;
+    if (!aborted && g != 0) {
+        const bool mover_wins = (g > 0) == mover_max;
+        v.result = mover_wins ? ProofNumberSolver::Result::Win : ProofNumberSolver::Result::Loss;
+        if (mover_wins) {
+            auto it = wl_tt.find(compact_state_key(b, mover_max, 0));
+            if (it != wl_tt.end()) v.move = it->second.best_move;
+        }
+    }
+    if (debug_level >= 1) {
+        const char* res = v.result == ProofNumberSolver::Result::Win  ? "WIN"
+                        : v.result == ProofNumberSolver::Result::Loss ? "LOSS" : "UNKNOWN";
+        LogMsgs::out() << "[solve-wl] " << res << " move=(" << v.move.first << ","
+                       << v.move.second << ") nodes=" << v.nodes << "\n";
+    }
+    return v;
+}
+
+int AI::wl_search(Board& board, bool is_max, int depth, int alpha, int beta, int max_depth) {
+    if (stop.requested.load(std::memory_order_relaxed) || (wl_budget && wl_nodes >= wl_budget)) {
+        aborted = true;
+        return 0;
+    }
+    ++wl_nodes;
+    eval_successors++;
+
+    const int required = max_depth - depth;
+    const CompactStateKey key = compact_state_key(board, is_max, 0);
+    Board::Move tt_move{-1, -1};
+    if (auto it = wl_tt.find(key); it != wl_tt.end()) {
+        const TTEntry& e = it->second;
+        if (e.depth >= required) {
+            if (e.bound == TTBound::Exact) return e.value;
+            if (e.bound == TTBound::Lower && e.value >= beta)  return e.value;
+            if (e.bound == TTBound::Upper && e.value <= alpha) return e.value;
+        }
+        tt_move = e.best_move;
+    }
+    // ±1000 é sempre exato (extremo da escala) e vale a qualquer profundidade
+    auto store = [&](int value, TTBound bound, Board::Move mv) {
+        if (aborted) return;
+        if (value != 0) wl_tt[key] = TTEntry{ value, kExactDepth, TTBound::Exact, mv };
+        else            wl_tt[key] = TTEntry{ value, required, bound, mv };
+    };
+
+    if (board.is_terminal()) {
+        const int val = evaluate_terminal(board, is_max);
+        store(val, TTBound::Exact, {-1, -1});
+        return val;
+    }
+    const auto mk = board.get_marker();
+    if (board.threatens_goal(mk.first, mk.second, /*max_goal=*/is_max)) {
+        const int val = is_max ? 1000 : -1000;
+        store(val, TTBound::Exact, is_max ? Board::Move{board.get_rows() - 1, 0}
+                                          : Board::Move{0, board.get_cols() - 1});
+        return val;
+    }
+    if (depth >= max_depth) return 0;
+
+    // (na raiz não: a vitória tem de vir com a jogada)
+    if (use_region_solver && depth > 0) {
+        auto reach = board.compute_distance();
+        if (reach.h1 == -900 && reach.h5 == 900) {
+            auto outcome = region_solver.solve(board);
+            if (outcome != RegionSolver::Outcome::Unknown) {
+                const int val = ((outcome == RegionSolver::Outcome::Win) == is_max) ? 1000 : -1000;
+                store(val, TTBound::Exact, {-1, -1});
+                return val;
+            }
+        }
+    }
+
+    // heurística só para ordenar (jogada da TT primeiro)
+    const int player_search = is_max ? 1 : 2;
+    const auto& successors = ordered_children(board, is_max, depth, max_depth, player_search);
+    const int n_children = static_cast<int>(successors.size());
+    std::array<int, 8> order{};
+    for (int i = 0; i < n_children; ++i) order[i] = i;
+    for (int i = 1; i < n_children && tt_move.first >= 0; ++i) {
+        if (successors[i] == tt_move) {
+            std::rotate(order.begin(), order.begin() + i, order.begin() + i + 1);
+            break;
+        }
+    }
+
+    const int alpha0 = alpha, beta0 = beta;
+    const Board::Move opp_goal = is_max ? Board::Move{0, board.get_cols() - 1}
+                                        : Board::Move{board.get_rows() - 1, 0};
+    int best = is_max ? -1000 : 1000;   // sem filhos -> quem joga perde
+    Board::Move best_move = n_children ? successors[order[0]] : Board::Move{-1, -1};
+    for (int oi = 0; oi < n_children; ++oi) {
+        const auto& mv = successors[order[oi]];
+        int score;
+        if (mv == opp_goal || board.threatens_goal(mv.first, mv.second, /*max_goal=*/!is_max)) {
+            score = is_max ? -1000 : 1000;   // entrega o objetivo ao adversário
+        } else {
+            const int line = board.forced_line_after(mv);
+            if (line >= 0) {
+                score = ((line % 2 == 0) == is_max) ? 1000 : -1000;
+            } else {
+                Board::MoveUndo undo = board.apply_move(mv);
+                score = wl_search(board, !is_max, depth + 1, alpha, beta, max_depth);
+                board.undo_move(undo);
+                if (aborted) return 0;
+            }
+        }
+        if (is_max ? score > best : score < best) { best = score; best_move = mv; }
+        if (is_max) alpha = std::max(alpha, score);
+        else        beta = std::min(beta, score);
+        if (alpha >= beta) break;
+    }
+
+    const TTBound bound = best <= alpha0 ? TTBound::Upper
+                        : best >= beta0  ? TTBound::Lower
+                                         : TTBound::Exact;
+    store(best, bound, best_move);
+    return best;
 }
 
 // Configuração da política de ordenação de sucessores e parâmetros associados
@@ -90,6 +240,65 @@ static char policy_tag(OrderingPolicy p) {
     return 'D';
 }
 
+// ----------------------------------------------------------------------------
+// Late Move Reductions:
+// - Tabuleiros pequenos têm pouca margem (árvores curtas, erros caros): reduz-se
+//   só a partir do 4º filho. Nos maiores a árvore é mais larga e funda, e os
+//   cortes concentram-se nos primeiros filhos: reduz-se a partir do 3º.
+// ----------------------------------------------------------------------------
+LMRParams LMRParams::for_board(int rows, int cols) {
+    LMRParams p;
+    if (rows * cols <= 36) {
+        p.full_moves = 3;
+        p.base = 0.25;
+        p.divisor = 2.5;
+    } else {
+        p.full_moves = 2;
+        p.base = 0.5;
+        p.divisor = 2.0;
+    }
+    return p;
+}
+
+bool AI::has_stalemating_move(const Board& board) {
+    const auto mk = board.get_marker();
+    // a célula do marcador ainda conta como livre, mas fica bloqueada ao sair
+    const int marker_free = board.grid_ref()[mk.first][mk.second] == 1 ? 1 : 0;
+    for (const auto& mv : board.valid_move_list().decode(mk)) {
+        if (board.free_neighbours(mv.first, mv.second) - marker_free == 0) return true;
+    }
+    return false;
+}
+
+void AI::set_lmr_params(int rows, int cols, const LMRParams& p) {
+    lmr_overrides[{rows, cols}] = p;
+    lmr_table.rows = 0;   // reconstruir na próxima consulta
+}
+
+// Redução (em plies) para o filho 'child_idx' com 'remaining' plies por procurar;
+// a tabela é construída uma vez por tamanho de tabuleiro.
+int AI::lmr_reduction(const Board& board, int remaining, int child_idx) {
+    const int R = board.get_rows(), C = board.get_cols();
+    if (lmr_table.rows != R || lmr_table.cols != C) {
+        auto it = lmr_overrides.find({R, C});
+        lmr_table.params = (it != lmr_overrides.end()) ? it->second : LMRParams::for_board(R, C);
+        lmr_table.rows = R;
+        lmr_table.cols = C;
+        const auto& p = lmr_table.params;
+        for (int rem = 0; rem < 64; ++rem) {
+            for (int idx = 0; idx < 8; ++idx) {
+                int red = 0;
+                if (rem >= p.min_remaining && idx >= p.full_moves && p.divisor > 0) {
+                    red = static_cast<int>(p.base + std::log(double(rem)) * std::log(double(idx + 1)) / p.divisor);
+                    red = std::max(0, std::min(red, rem - 1));   // nunca salta o próprio filho
+                }
+                lmr_table.r[rem][idx] = static_cast<uint8_t>(red);
+            }
+        }
+    }
+    return lmr_table.r[std::min(remaining, 63)][std::min(child_idx, 7)];
+}
+
 void AI::reset_ordering_stats() {
     ord_max_ = OrderingStats{};
     ord_min_ = OrderingStats{};
@@ -119,6 +328,24 @@ namespace {
 }
 #endif
 
+// Gerador usado pela 1ª jogada aleatória e pelas políticas de ordenação com
+// ruído: semente fixa (set_seed) -> jogos reprodutíveis; senão o dos testes
+// ou um por thread semeado pelo random_device.
+std::mt19937& AI::rng() {
+    if (seeded) return seeded_rng;
+#ifdef RASTROS_TESTS
+    return test_rng();
+#else
+    static thread_local std::mt19937 gen{std::random_device{}()};
+    return gen;
+#endif
+}
+
+void AI::set_seed(uint64_t seed) {
+    seeded = true;
+    seeded_rng.seed(static_cast<std::mt19937::result_type>(seed ^ (seed >> 32)));
+}
+
 
 
 //AI::AI(bool is_max, int max_depth) : is_max(is_max), max_depth(max_depth) {}
@@ -137,11 +364,6 @@ AI::AI(bool is_max, int max_depth)
     heuristic = [this](const Board& board, bool max) {
         return this->default_heuristic(board, max);
     };
-        AI::count_visited = 0;
-        AI::vs_lookups = 0;
-        AI::vs_hits = 0;
-        AI::vs_inserts = 0;
-
 }
 
 // ----------------------------------------------------------------------------
@@ -152,11 +374,6 @@ AI::AI(bool is_max, int max_depth)
 // ----------------------------------------------------------------------------
 AI::AI(bool is_max, int max_depth, std::function<int(const Board&, bool)> heuristic_func,int debug_level)
     : is_max(is_max), max_depth(max_depth), heuristic(heuristic_func) ,debug_level(debug_level){
-        AI::count_visited = 0;
-        AI::vs_lookups = 0;
-        AI::vs_hits = 0;
-        AI::vs_inserts = 0;
-
     }
 
 // Encaminha para a heurística configurada
@@ -169,11 +386,6 @@ int AI::total_heuristic(const Board& board, bool is_max) {
 // Mapa global de níveis → função heurística
 std::map<int, std::function<int(const Board&, bool)>> AI::heuristic_levels;
 
-// getter para obter o turno
-// criado para experimentar ativação de heurísticas em diferentes fases do jogo
-// não está a ser utilizado
-int AI::rounds() { return s_rounds; }
-
 // ----------------------------------------------------------------------------
 // register_heuristics():
 // - Regista as heurísticas disponíveis por nível (1..10).
@@ -272,10 +484,20 @@ std::unique_ptr<AI> AI::create_with_level(bool is_max, int depth, int level, int
 //   e corre minimax com profundidade 'depth_override' ou 'max_depth' por defeito.
 // ----------------------------------------------------------------------------
 std::pair<int, int> AI::choose_move(Board& board, int depth_override, int rounds) {
+    SearchArena::Scope arena_scope(ctx->arena);
 
-     AI::s_rounds = rounds;
+    ctx->rounds = rounds;
     last_max_depth_reached = 0;
+    last_best_score = 0;
+    aborted = false;
+    budget_nodes = 0;
+    completed_depth = 0;
     const auto start_time = std::chrono::steady_clock::now();
+    deadline_hit = false;
+    int limit_ms = move_time_ms;
+    if (hard_time_ms > 0) limit_ms = limit_ms > 0 ? std::min(limit_ms, hard_time_ms) : hard_time_ms;
+    use_deadline = limit_ms > 0;
+    if (use_deadline) deadline = start_time + std::chrono::milliseconds(limit_ms);
     const char* player = is_max ? "MAX" : "MIN";
 
     auto run_minimax = [&](Board& tmp, bool child_is_max, int depth_used, int player_search) {
@@ -349,12 +571,7 @@ std::pair<int, int> AI::choose_move(Board& board, int depth_override, int rounds
 
         if (initial_moves.empty()) return std::nullopt;
 
-        #ifdef RASTROS_TESTS
-          auto& gen = test_rng();
-        #else
-          std::random_device rd;
-          std::mt19937 gen(rd());
-        #endif
+        auto& gen = rng();
         std::uniform_int_distribution<int> dis(0, static_cast<int>(initial_moves.size() - 1));
         auto move = initial_moves[dis(gen)];
         if (debug_level == 1) {
@@ -365,17 +582,55 @@ std::pair<int, int> AI::choose_move(Board& board, int depth_override, int rounds
         return move;
     };
 
+    // Tabuleiros pequenos com BD de jogo perfeito: se a posição é vitória
+    // conhecida, a jogada vencedora sai em O(1) (antes da 1ª jogada aleatória).
+    // Posições perdidas ou fora da BD seguem para a procura normal.
+    if (use_perfect_db) {
+        if (const auto* db = PerfectPlayDB::for_size(board.get_rows(), board.get_cols())) {
+            Board::Move mv;
+            if (db->winning_move(board, is_max, mv)) {
+                last_best_score = adjust_terminal_score(is_max ? 1000 : -1000, 1);
+                if (debug_level >= 1) {
+                    LogMsgs::out() << "[perfect-db] " << player << " -> (" << mv.first << ","
+                                   << mv.second << ")";
+                    log_move_time();
+                    LogMsgs::out() << "\n";
+                }
+                return mv;
+            }
+        }
+    }
+
     if (auto fm = first_move_avoid_goal()) {
         return *fm;
     }
 
+    const int depth_used = (depth_override != -1) ? depth_override : max_depth;
+
+    // Livro de aberturas: posições iniciais já procuradas offline a profundidade
+    // >= depth_used saem sem procura (a 1ª jogada mantém a escolha aleatória).
+    if (use_opening_book) {
+        if (const auto* book = OpeningBook::for_size(board.get_rows(), board.get_cols())) {
+            OpeningBook::Hit hit;
+            if (book->get_depth() >= depth_used && book->lookup(board, is_max, hit)) {
+                last_best_score = is_max ? hit.score : -hit.score;
+                if (debug_level >= 1) {
+                    LogMsgs::out() << "[book] " << player << " -> (" << hit.move.first << ","
+                                   << hit.move.second << ") score=" << last_best_score
+                                   << " d=" << hit.depth;
+                    log_move_time();
+                    LogMsgs::out() << "\n";
+                }
+                return hit.move;
+            }
+        }
+    }
+
     // Caches por raiz (limpas a cada chamada)
     //clear_ordering_caches();
     clear_order_caches();
     clear_s_heuristic_caches();
 
-
-    const int depth_used = (depth_override != -1) ? depth_override : max_depth;
     const auto pos = board.get_marker();
     int player_search = is_max ? 1 : 2;
 
@@ -388,7 +643,7 @@ std::pair<int, int> AI::choose_move(Board& board, int depth_override, int rounds
     if (debug_level >= 2) {
         std::vector<std::pair<int,int>> rootMoves;
         rootMoves.reserve(rootSuccessors.size());
-        for (const auto& ms : rootSuccessors) rootMoves.push_back(ms.move);
+        for (const auto& ms : rootSuccessors) rootMoves.push_back(ms);
         LogMsgs::AI::log_root_moves(pos, rootMoves, depth_override);
     }
 
@@ -400,54 +655,140 @@ std::pair<int, int> AI::choose_move(Board& board, int depth_override, int rounds
         return {-1, -1}; // sem jogadas possíveis
     }
 
-    int best_score = is_max ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
-    int depth_used_for_best = 0;
-    std::pair<int, int> best_move = rootSuccessors.front().move; // fallback (primeiro)
-
-    // nº de traços para árvore de debug
-    // const int dash = std::max(0, depth_used - 1);
-
-    for (const auto& ms : rootSuccessors) {
-        Board tmp = board;
-        tmp.make_move(ms.move);
-
-        // Atalho: se o sucessor é terminal e é vitória para quem acabou de jogar, retorna já.
-        if (tmp.is_terminal()) {
-            int v = adjust_terminal_score(evaluate_terminal(tmp, /*perspetiva do sucessor*/ !is_max),
-                                          /*depth*/ 1);
-            if ((is_max && v > 0) || (!is_max && v < 0)) {
-                if (debug_level == 1) {
-            LogMsgs::AI::log_immediate_win(is_max, ms.move, v);
-            log_move_time();
-            LogMsgs::out() << "\n";
-        }
-                // log_move_time("immediate win");
-                return ms.move;  // jogada vencedora a profundidade 1
+    // Uma passagem pela raiz à profundidade d, com 'first' (melhor jogada da
+    // iteração anterior) à frente. false se interrompida (paragem/orçamento):
+    // out_* ficam com o melhor dos filhos já avaliados.
+    std::optional<std::pair<int, int>> immediate_win;
+    std::vector<Board::Move> iter_pv;   // PV da melhor jogada (só com progress_cb)
+    auto search_root = [&](int d, const std::pair<int, int>& first,
+                           int& out_score, std::pair<int, int>& out_move) -> bool {
+        begin_extension_iteration(d);
+        out_score = is_max ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+        out_move = rootSuccessors.front(); // fallback (primeiro)
+        iter_pv.clear();
+        const int n_root = static_cast<int>(rootSuccessors.size());
+        std::vector<int> order(n_root);
+        for (int i = 0; i < n_root; ++i) order[i] = i;
+        for (int i = 1; i < n_root; ++i) {
+            if (rootSuccessors[i] == first) {
+                std::rotate(order.begin(), order.begin() + i, order.begin() + i + 1);
+                break;
             }
-            // Caso contrário (terminal mas perde), continua a avaliar os restantes
         }
 
+        for (int oi = 0; oi < n_root; ++oi) {
+            const auto& ms = rootSuccessors[order[oi]];
+            Board tmp = board;
+            tmp.make_move(ms);
+
+            // Atalho: se o sucessor é terminal e é vitória para quem acabou de jogar, retorna já.
+            if (tmp.is_terminal()) {
+                int v = adjust_terminal_score(evaluate_terminal(tmp, /*perspetiva do sucessor*/ !is_max),
+                                              /*depth*/ 1);
+                if ((is_max && v > 0) || (!is_max && v < 0)) {
+                    out_score = v;
+                    immediate_win = ms;  // jogada vencedora a profundidade 1
+                    return true;
+                }
+                // Caso contrário (terminal mas perde), continua a avaliar os restantes
+            }
 
-        if (debug_level >= 2) {
-            bool last_root_child = (&ms == &rootSuccessors.back());
-            LogMsgs::AI::log_root_trying_move(player, ms.move, last_root_child);
-        }
+            if (debug_level >= 2) {
+                bool last_root_child = (oi == n_root - 1);
+                LogMsgs::AI::log_root_trying_move(player, ms, last_root_child);
+            }
 
+            int score;
+            if (track_pv) pv_len[1] = 0;
+            // Beco sem saída: a linha forçada decide o jogo (vitória/derrota a 'line' plies)
+            int line = use_corridor_macros ? board.forced_line_after(ms) : -1;
+            if (line >= 0) {
+                const bool mover_wins = (line % 2 == 0);
+                score = (mover_wins == is_max) ? 1000 - line : -(1000 - line);
+                stats_for(is_max).dead_ends++;
+            } else {
+                score = run_minimax(tmp, /*child_is_max=*/!is_max, d, player_search);
+                if (aborted) return false;   // paragem pedida: o score deste filho não conta
+            }
 
-        
-        int score = run_minimax(tmp, /*child_is_max=*/!is_max, depth_used, player_search);
+            if (debug_level >= 2) {
+                bool last_root_child = (oi == n_root - 1);
+                LogMsgs::AI::log_root_score(ms, score, last_root_child);
+            }
 
-        if (debug_level >= 2) {
-            bool last_root_child = (&ms == &rootSuccessors.back());
-            LogMsgs::AI::log_root_score(ms.move, score, last_root_child);
+            if ((is_max && score > out_score) || (!is_max && score < out_score)) {
+                out_score = score;
+                out_move = ms;
+                if (track_pv) {
+                    iter_pv.assign(1, ms);
+                    iter_pv.insert(iter_pv.end(), pv_table.begin() + kMaxPly,
+                                   pv_table.begin() + kMaxPly + pv_len[1]);
+                }
+            }
         }
+        return true;
+    };
 
-
-
-        if ((is_max && score > best_score) || (!is_max && score < best_score)) {
+    int best_score = 0;
+    std::pair<int, int> best_move = rootSuccessors.front();
+    if (node_budget == 0 && !use_deadline && soft_time_ms == 0 && !progress_cb) {
+        if (search_root(depth_used, {-1, -1}, best_score, best_move)) completed_depth = depth_used;
+    } else {
+        // Orçamento de nós/tempo ou progresso pedido: aprofundamento iterativo;
+        // uma iteração cortada a meio é descartada (a ordem dos filhos não a
+        // torna comparável às completas)
+        if (progress_cb) {
+            track_pv = true;
+            pv_table.assign(kMaxPly * kMaxPly, Board::Move{-1, -1});
+            pv_len.assign(kMaxPly, 0);
+        }
+        int stable_iters = 0;
+        double last_iter_ms = 0.0;
+        for (int d = 1; d <= depth_used && !immediate_win; ++d) {
+            int score;
+            std::pair<int, int> move;
+            const auto iter_start = std::chrono::steady_clock::now();
+            if (!search_root(d, best_move, score, move)) break;
+            const bool changed = completed_depth > 0 && move != best_move;
+            stable_iters = changed ? 0 : stable_iters + 1;
             best_score = score;
-            best_move = ms.move;
+            best_move = move;
+            completed_depth = d;
+            const auto now = std::chrono::steady_clock::now();
+            last_iter_ms = std::chrono::duration<double, std::milli>(now - iter_start).count();
+            if (progress_cb) {
+                const double secs = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start_time).count();
+                SearchProgress p;
+                p.depth = d;
+                p.score = score;
+                p.nodes = budget_nodes;
+                p.nps = secs > 0 ? budget_nodes / secs : 0.0;
+                p.best_move = move;
+                p.pv = iter_pv;
+                if (p.pv.empty()) p.pv.push_back(move);
+                progress_cb(p);
+            }
+            if (soft_time_ms > 0) {
+                // gestão do relógio: a iteração seguinte custa pelo menos tanto como esta
+                const double elapsed = std::chrono::duration<double, std::milli>(now - start_time).count();
+                const double scale = changed ? 2.0 : (stable_iters >= 3 ? 0.5 : 1.0);
+                if (elapsed >= soft_time_ms * scale) break;
+                if (hard_time_ms > 0 && elapsed + 2.0 * last_iter_ms > hard_time_ms) break;
+            }
+        }
+        track_pv = false;
+        if (completed_depth > 0 && !stop.requested.load(std::memory_order_relaxed)) aborted = false;
+    }
+
+    if (immediate_win) {
+        last_best_score = best_score;
+        if (debug_level == 1) {
+            LogMsgs::AI::log_immediate_win(is_max, *immediate_win, best_score);
+            log_move_time();
+            LogMsgs::out() << "\n";
         }
+        return *immediate_win;
     }
 
     if (debug_level >= 1) {
@@ -460,10 +801,228 @@ std::pair<int, int> AI::choose_move(Board& board, int depth_override, int rounds
     }
     // log_move_time("search complete");
 
+    last_best_score = best_score;
     unplayable_cells_count++;
     return best_move;
 }
 
+// ----------------------------------------------------------------------------
+// start_search(board, limits, on_progress):
+// - choose_move numa thread própria, com os limites de nós/tempo aplicados só
+//   a esta procura e o progresso de cada iteração enviado a 'on_progress' e
+//   guardado no handle (last_progress).
+// - O resultado chega por std::shared_future; stop() interrompe e fica a
+//   jogada da última iteração completa.
+// ----------------------------------------------------------------------------
+SearchHandle AI::start_search(const Board& board, const SearchLimits& limits,
+                              std::function<void(const SearchProgress&)> on_progress) {
+    SearchHandle h;
+    h.ai = this;
+    h.shared = std::make_shared<SearchHandle::Shared>();
+    clear_stop();   // um pedido antigo não pode cortar esta procura
+
+    auto promise = std::make_shared<std::promise<SearchResult>>();
+    h.result = promise->get_future().share();
+    auto shared = h.shared;
+    auto job = [this, root = Board(board), limits, on_progress, promise, shared]() mutable {
+        const uint64_t saved_budget = node_budget;
+        const int saved_time = move_time_ms;
+        auto saved_cb = std::move(progress_cb);
+        node_budget = limits.nodes;
+        move_time_ms = limits.time_ms;
+        progress_cb = [&](const SearchProgress& p) {
+            {
+                std::lock_guard<std::mutex> lock(shared->mtx);
+                shared->progress = p;
+            }
+            if (on_progress) on_progress(p);
+        };
+
+        const int depth = limits.depth > 0 ? limits.depth : max_depth;
+        SearchResult r;
+        r.move = choose_move(root, depth, limits.rounds);
+        r.score = last_best_score;
+        r.depth = completed_depth;
+        r.nodes = budget_nodes;
+        r.stopped = completed_depth < depth &&
+                    (stop.requested.load(std::memory_order_relaxed) || deadline_hit ||
+                     (node_budget && budget_nodes >= node_budget));
+
+        node_budget = saved_budget;
+        move_time_ms = saved_time;
+        progress_cb = std::move(saved_cb);
+        promise->set_value(r);
+    };
+
+    #if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    job();   // build WASM sem pthreads: corre já (o handle fica pronto)
+    #else
+    h.worker = std::thread(std::move(job));
+    #endif
+    return h;
+}
+
+// O handle movido fica sem AI: o seu destrutor não pode parar a procura
+// que passou a pertencer a este (p.ex. std::make_shared nos bindings)
+SearchHandle::SearchHandle(SearchHandle&& o) noexcept
+    : ai(o.ai), worker(std::move(o.worker)), result(std::move(o.result)), shared(std::move(o.shared)) {
+    o.ai = nullptr;
+}
+
+SearchHandle& SearchHandle::operator=(SearchHandle&& o) {
+    if (this != &o) {
+        stop();
+        if (worker.joinable()) worker.join();
+        ai = o.ai;
+        worker = std::move(o.worker);
+        result = std::move(o.result);
+        shared = std::move(o.shared);
+        o.ai = nullptr;
+    }
+    return *this;
+}
+
+SearchHandle::~SearchHandle() {
+    stop();
+    wait();
+}
+
+void SearchHandle::stop() {
+    if (ai && !ready()) ai->request_stop();
+}
+
+SearchResult SearchHandle::wait() {
+    if (!result.valid()) return SearchResult{};
+    if (worker.joinable()) {
+        worker.join();
+        ai->clear_stop();   // um stop() tardio não pode cortar a procura seguinte
+    }
+    return result.get();
+}
+
+bool SearchHandle::ready() const {
+    return result.valid() &&
+           result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+SearchProgress SearchHandle::last_progress() const {
+    if (!shared) return SearchProgress{};
+    std::lock_guard<std::mutex> lock(shared->mtx);
+    return shared->progress;
+}
+
+// ----------------------------------------------------------------------------
+// analyse(board, k, limits):
+// - As k melhores jogadas da raiz com score exato, PV e nós gastos (dicas na
+//   UI, análise de erros) numa só procura, em vez de uma por candidata.
+// - Aprofundamento iterativo: cada iteração começa pelas k melhores da
+//   anterior. As k primeiras jogadas levam janela completa; as seguintes só
+//   uma janela aberta acima (MAX) / abaixo (MIN) da k-ésima, pelo que um
+//   fail-low as exclui sem valor exato e um valor dentro da janela é exato.
+// - A PV vem da tabela triangular preenchida pelo minimax (track_pv); fica
+//   truncada onde o valor veio da TT ou de um solver.
+// - Com limits.nodes, devolve a última iteração completa (como set_node_budget).
+// ----------------------------------------------------------------------------
+std::vector<RootLine> AI::analyse(const Board& board, int k, const AnalysisLimits& limits) {
+    SearchArena::Scope arena_scope(ctx->arena);
+    std::vector<RootLine> lines;
+    if (k <= 0 || board.is_terminal()) return lines;
+
+    aborted = false;
+    budget_nodes = 0;
+    completed_depth = 0;
+    use_deadline = deadline_hit = false;
+    const uint64_t saved_budget = node_budget;
+    node_budget = limits.nodes;
+    const int depth_limit = limits.depth > 0 ? limits.depth : max_depth;
+    const int player_search = is_max ? 1 : 2;
+
+    clear_order_caches();
+    clear_s_heuristic_caches();
+    Board root = board;
+    std::vector<Board::Move> order;
+    for (const auto& ms : ordered_children(root, is_max, /*depth*/0, depth_limit, player_search))
+        order.push_back(ms);
+    k = std::min<int>(k, static_cast<int>(order.size()));
+
+    pv_table.assign(kMaxPly * kMaxPly, Board::Move{-1, -1});
+    pv_len.assign(kMaxPly, 0);
+    track_pv = true;
+
+    auto better = [&](int a, int b) { return is_max ? a > b : a < b; };
+
+    for (int d = 1; d <= depth_limit; ++d) {
+        std::vector<RootLine> iter;   // top-k da iteração, melhor primeiro
+        begin_extension_iteration(d);
+        bool complete = true;
+        for (const auto& mv : order) {
+            Board child = root;
+            child.make_move(mv);
+            const uint64_t nodes0 = budget_nodes;
+            last_max_depth_reached = 0;
+            const bool narrowed = static_cast<int>(iter.size()) == k;
+
+            RootLine line;
+            line.move = mv;
+            line.depth = d;
+            line.pv.push_back(mv);
+            int line_len = -1;
+            if (child.is_terminal()) {
+                line.score = adjust_terminal_score(evaluate_terminal(child, !is_max), /*depth*/ 1);
+            } else if (int fl = use_corridor_macros ? root.forced_line_after(mv) : -1; fl >= 0) {
+                const bool mover_wins = (fl % 2 == 0);
+                line.score = (mover_wins == is_max) ? 1000 - fl : -(1000 - fl);
+            } else {
+                int alpha = std::numeric_limits<int>::min();
+                int beta = std::numeric_limits<int>::max();
+                if (narrowed) (is_max ? alpha : beta) = iter.back().score;
+                line.score = minimax(child, !is_max, /*depth=*/1, alpha, beta, d, player_search);
+                if (aborted) { complete = false; break; }
+                line_len = pv_len[1];
+            }
+            line.nodes = budget_nodes - nodes0;
+            line.seldepth = std::max(1, last_max_depth_reached);
+            if (narrowed && !better(line.score, iter.back().score)) continue;
+
+            for (int i = 0; i < line_len; ++i) line.pv.push_back(pv_table[kMaxPly + i]);
+            auto at = std::upper_bound(iter.begin(), iter.end(), line,
+                                       [&](const RootLine& x, const RootLine& y) { return better(x.score, y.score); });
+            iter.insert(at, std::move(line));
+            if (static_cast<int>(iter.size()) > k) iter.pop_back();
+        }
+        if (!complete) break;
+
+        lines = std::move(iter);
+        completed_depth = d;
+        // próxima iteração: as k melhores à frente, as restantes pela ordem anterior
+        std::vector<Board::Move> next;
+        for (const auto& l : lines) next.push_back(l.move);
+        for (const auto& mv : order)
+            if (std::find(next.begin(), next.end(), mv) == next.end()) next.push_back(mv);
+        order.swap(next);
+    }
+
+    track_pv = false;
+    node_budget = saved_budget;
+    if (completed_depth > 0 && !stop.requested.load(std::memory_order_relaxed)) aborted = false;
+    if (!lines.empty()) last_best_score = lines.front().score;
+    return lines;
+}
+
+// Linha da PV no ply 'ply': moves[0..n) seguidas da linha do ply 'ply + n'
+void AI::pv_splice(int ply, const Board::Move* moves, int n) {
+    if (ply >= kMaxPly) return;
+    Board::Move* row = &pv_table[ply * kMaxPly];
+    const int cap = kMaxPly - ply;   // triangular: a linha do ply p cabe em kMaxPly - p
+    int len = 0;
+    for (; len < n && len < cap; ++len) row[len] = moves[len];
+    if (ply + n < kMaxPly) {
+        const Board::Move* tail = &pv_table[(ply + n) * kMaxPly];
+        for (int i = 0; i < pv_len[ply + n] && len < cap; ++i) row[len++] = tail[i];
+    }
+    pv_len[ply] = len;
+}
+
 // // ----------------------------------------------------------------------------
 // // minimax(board, is_max, depth, alpha, beta, max_depth):
 // // - Implementa Minimax cokm cortes Alpha–Beta e memorização de estados visitados.
@@ -471,10 +1030,17 @@ std::pair<int, int> AI::choose_move(Board& board, int depth_override, int rounds
 // // uma entrada na tabela de transposição que contém( val,depth, bound)
 // // - Se terminal: 'evaluate_terminal' devolve ±1000 (ou 0).
 // // - Se profundidade limite: usa 'total_heuristic'. -> podendo estender
-// // via quiescence search caso esteja ativa. (não está a ser utilizada)
+// // via quiescence search caso esteja ativa (set_quiescence).
 // // - Ordenação de jogadas para melhorar eficácia dos cortes.
 // // ----------------------------------------------------------------------------
 int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int max_depth, int player_search) {
+    if (track_pv && depth < kMaxPly) pv_len[depth] = 0;
+    // confirmação do razoring: só este nó (não os descendentes) salta a futilidade
+    const bool razor_verify = std::exchange(razor_check, false);
+    if (search_limit_hit()) {
+        aborted = true;
+        return 0;
+    }
     last_max_depth_reached = std::max(last_max_depth_reached, depth);
 
     CompactStateKey key = compact_state_key(board, is_max, player_search);
@@ -490,20 +1056,22 @@ int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int m
         return false;
     };
     auto tt_store = [&](const TTEntry& entry) {
+        if (aborted) return;   // valores de uma procura interrompida não são fiáveis
         tt[key] = entry;
-        vs_inserts++;
+        ctx->vs_inserts++;
     };
 
     eval_successors++;
-    vs_lookups++;
+    budget_nodes++;
+    ctx->vs_lookups++;
 
     const int required = max_depth - depth;
 
     TTEntry cached{};
     if (tt_lookup(cached)) {
         if (cached.depth >= required) {
-            vs_hits++;
-            count_visited++;
+            ctx->vs_hits++;
+            ctx->count_visited++;
             if (debug_level >= 5) {
             LogMsgs::out() << indent_rails(depth)
                           << "[hit] key=" << key_label()
@@ -546,24 +1114,32 @@ int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int m
         return val;
     }
 
-    const bool use_quiescence = false;
+    // Vitória imediata: o marcador está ao lado do próprio objetivo livre.
+    // (também no horizonte: substitui a heurística por um valor exato)
+    if (use_goal_threats) {
+        const auto mk = board.get_marker();
+        if (board.threatens_goal(mk.first, mk.second, /*max_goal=*/is_max)) {
+            int val = adjust_terminal_score(is_max ? 1000 : -1000, depth);
+            stats_for(is_max).immediate_wins++;
+            if (debug_level >= 4) {
+                LogMsgs::out() << indent_rails(depth) << "goal in 1: " << val << "\n";
+            }
+            TTEntry e{ val, kExactDepth, TTBound::Exact };
+            tt_store(e);
+            return val;
+        }
+    }
+
     if (depth >= max_depth) {
         if (use_quiescence) {
-            if (debug_level >= 2) {
+            if (debug_level >= 3) {
             LogMsgs::out() << "[Q] entering quiescence at depth=" << depth << "\n";
             }
-            return quiescence(board, is_max, alpha, beta, /*qdepth=*/0, /*base_depth=*/depth);
+            // valor pode ser um limite (fail-high/low): só a qtt o guarda, com o tipo certo
+            return quiescence(board, is_max, alpha, beta, /*qdepth=*/0, /*base_depth=*/depth,
+                              player_search);
         } else {
-            auto mk_leaf = board.get_marker();
-            CompactHeuristicKey chk{board.get_hash(), is_max, max_depth, player_search,
-                                    mk_leaf.first, mk_leaf.second};
-            int val;
-            if (auto it = s_heuristic_cache.find(chk); it != s_heuristic_cache.end()) {
-                val = it->second;
-            } else {
-                val = total_heuristic(board, is_max);
-                s_heuristic_cache[chk] = val;
-            }
+            int val = leaf_heuristic(board, is_max, max_depth, player_search);
             TTEntry e{ val, 0, TTBound::Exact };
             tt_store(e);
             if (debug_level >= 5) {
@@ -575,6 +1151,168 @@ int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int m
         }
     }
 
+    // Objetivos inalcançáveis: o resto do jogo é "quem fica sem jogadas primeiro"
+    // dentro da região do marcador -> resolve-se de forma exata e termina aqui.
+    // (no último ply antes do horizonte fica a paridade da heurística: evita um
+    // BFS extra no nível interior mais numeroso). Regiões do tamanho de uma que
+    // já esgotou o orçamento do solver são recusadas antes do DFS.
+    if (use_region_solver && required >= 2) {
+        auto reach = board.compute_distance();
+        if (reach.h1 == -900 && reach.h5 == 900) {
+            auto outcome = region_solver.solve(board);
+            if (outcome != RegionSolver::Outcome::Unknown) {
+                const bool mover_wins = (outcome == RegionSolver::Outcome::Win);
+                int val = (mover_wins == is_max) ? 1000 : -1000;
+                // Valor à distância mínima do bloqueio (não "já"): fica coerente
+                // com os limites da corrida nos antepassados
+                if (use_race_bounds) {
+                    const auto rb = RaceBounds::compute(board, is_max);
+                    const bool max_wins = (mover_wins == is_max);
+                    if ((max_wins ? rb.max_win_ply : rb.min_win_ply) != RaceBounds::kNever) {
+                        val = max_wins ? rb.max_win_score(depth) : rb.min_win_score(depth);
+                    }
+                }
+                stats_for(is_max).region_solved++;
+                if (debug_level >= 4) {
+                    LogMsgs::out() << indent_rails(depth)
+                                     << "region solved: " << val << "\n";
+                }
+                TTEntry e{ val, kExactDepth, TTBound::Exact };
+                tt_store(e);
+                return val;
+            }
+        }
+    }
+
+    // Limites de distância ao mate: daqui, o melhor possível é ganhar no ply
+    // seguinte (1000 - depth) e o pior é perder nele. As heurísticas ficam
+    // bem abaixo destes valores, por isso o corte é exato.
+    if (use_goal_threats) {
+        const int mate = 1000 - depth;
+        if (alpha < -mate) alpha = -mate;
+        if (beta > mate) beta = mate;
+        if (alpha >= beta) {
+            stats_for(is_max).mate_cutoffs++;
+            return alpha;
+        }
+    }
+
+    // Limites da corrida: só há corte possível com a janela já em valores de
+    // mate (uma vitória encontrada noutro ramo); a BFS fica para esses nós.
+    if (use_race_bounds &&
+        (alpha >= RaceBounds::kHeuristicBound || beta <= -RaceBounds::kHeuristicBound)) {
+        const auto rb = RaceBounds::compute(board, is_max);
+        alpha = std::max(alpha, rb.lower(depth));
+        beta = std::min(beta, rb.upper(depth));
+        if (alpha >= beta) {
+            stats_for(is_max).race_cutoffs++;
+            return alpha;
+        }
+    }
+
+    // Corredor: quem joga tem uma única jogada -> aplica a sequência forçada
+    // como macro-jogada (sem ordenação/heurística nem TT nos nós intermédios);
+    // cada ply consome profundidade e alterna o lado, como na descida normal.
+    if (use_corridor_macros) {
+        Board::MoveUndo undos[kMaxCorridor];
+        Board::Move path[kMaxCorridor];
+        int k = 0;
+        bool side = is_max;
+        while (k < kMaxCorridor && depth + k < max_depth && !board.is_terminal()) {
+            Board::Move only{};
+            if (!single_move(board, only)) break;
+            path[k] = only;
+            undos[k++] = board.apply_move(only);
+            side = !side;
+        }
+        if (k > 0) {
+            stats_for(is_max).corridor_plies += k;
+            if (debug_level >= 4) {
+                LogMsgs::out() << indent_rails(depth) << "corridor: " << k << " plies\n";
+            }
+            // resposta única: cada ply do corredor pode devolver a profundidade que consumiu
+            const int ext = std::max(0, std::min(k, extension_room(max_depth)));
+            extensions_left -= ext;
+            stats_for(is_max).extensions += ext;
+            int score = minimax(board, side, depth + k, alpha, beta, max_depth + ext, player_search);
+            score = adjust_terminal_score(score, depth + k - 1);
+            if (track_pv) pv_splice(depth, path, k);
+            while (k > 0) board.undo_move(undos[--k]);
+
+            TTBound bound = score >= beta  ? TTBound::Lower
+                          : score <= alpha ? TTBound::Upper
+                                           : TTBound::Exact;
+            TTEntry e{ score, required, bound };
+            tt_store(e);
+            return score;
+        }
+    }
+
+    // Futilidade (1 ply do horizonte) e razoring (2 plies): se a avaliação
+    // estática mais a margem nem chega à janela, os filhos dificilmente chegam.
+    // A fronteira devolve logo o limite; o razoring confirma com uma procura
+    // de janela nula a um ply que expande os filhos (sem o corte de fronteira,
+    // que daria logo a mesma resposta). Jogadas que bloqueiam o adversário
+    // (vitória que a heurística não vê) desligam o corte.
+    if (use_futility && required <= 2 && !razor_verify) {
+        const int stand = leaf_heuristic(board, is_max, max_depth, player_search);
+        const int margin = (required == 1) ? futility.frontier_margin : futility.razor_margin;
+        const bool hopeless = is_max ? stand + margin <= alpha : stand - margin >= beta;
+        if (hopeless && !has_stalemating_move(board)) {
+            if (required == 1) {
+                stats_for(is_max).futility_prunes++;
+                return is_max ? stand + margin : stand - margin;
+            }
+            const int lo = is_max ? alpha : beta - 1;
+            razor_check = true;
+            int v = minimax(board, is_max, depth, lo, lo + 1, max_depth - 1, player_search);
+            razor_check = false;
+            if (is_max ? v <= alpha : v >= beta) {
+                stats_for(is_max).razor_prunes++;
+                return v;
+            }
+        }
+    }
+
+    // ETC: antes de ordenar/expandir, procura cada filho na TT (hash incremental,
+    // sem aplicar a jogada). Um limite guardado que já corta a janela dispensa
+    // a expansão: muitas ordens de jogadas bloqueiam as mesmas casas.
+    if (use_etc && required >= kEtcMinRemaining) {
+        for (const auto& mv : board.valid_move_list().decode(board.get_marker())) {
+            const CompactStateKey ck{board.hash_after(mv), mv.first, mv.second, !is_max, player_search};
+            auto it = tt.find(ck);
+            if (it == tt.end() || it->second.depth < required - 1) continue;
+            const TTEntry& child = it->second;
+            const int v = adjust_terminal_score(child.value, depth);
+            const bool cut = is_max ? (child.bound != TTBound::Upper && v >= beta)
+                                    : (child.bound != TTBound::Lower && v <= alpha);
+            if (cut) {
+                stats_for(is_max).etc_cutoffs++;
+                if (debug_level >= 4) {
+                    LogMsgs::out() << indent_rails(depth) << "etc cut: (" << mv.first << ","
+                                   << mv.second << ") " << v << "\n";
+                }
+                TTEntry e{ v, required, is_max ? TTBound::Lower : TTBound::Upper, mv };
+                tt_store(e);
+                return v;
+            }
+        }
+    }
+
+    // IID: nó profundo sem jogada na TT (nem de uma iteração anterior) -> uma
+    // procura reduzida primeiro, só para ter uma jogada que abra a completa;
+    // a ordenação heurística de um ply falha muito a esta profundidade.
+    Board::Move tt_move = cached.best_move;
+    bool iid_move = false;
+    if (use_iid && tt_move.first < 0 && required >= iid_min_remaining) {
+        stats_for(is_max).iid_searches++;
+        minimax(board, is_max, depth, alpha, beta, max_depth - iid_reduction, player_search);
+        if (aborted) return 0;
+        TTEntry reduced{};
+        if (tt_lookup(reduced)) tt_move = reduced.best_move;
+        iid_move = tt_move.first >= 0;
+    }
+
     const auto pos = board.get_marker();
     const char* player   = is_max ? "MAX" : "MIN";
     const char* opponent = is_max ? "MIN" : "MAX";
@@ -592,7 +1330,7 @@ int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int m
         LogMsgs::out() << indent_rails(depth)
                          << "(" << pos.first << "," << pos.second << ")->";
         for (const auto& ms : successors) {
-            LogMsgs::out() << "(" << ms.move.first << ", " << ms.move.second << "), ";
+            LogMsgs::out() << "(" << ms.first << ", " << ms.second << "), ";
         }
         LogMsgs::out() << "eval [" << opponent << "] position to [" << player << "]\n";
     }
@@ -600,28 +1338,95 @@ int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int m
     gen_successors += successors.size();
 
     int best = is_max ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+    Board::Move best_move{-1, -1};
     bool expanded_child = false;
 
-    for (const auto& ms : successors) {
-
-        Board::MoveUndo undo = board.apply_move(ms.move);
-
+    // Extensão: resposta única ou corrida a <= 2 passos de um objetivo -> os
+    // filhos descem mais um ply (táticas decididas no horizonte, sem quiescence)
+    int child_max_depth = max_depth;
+    if (extension_room(max_depth) > 0 &&
+        (successors.size() == 1 || goal_race_near(board))) {
+        --extensions_left;
+        ++child_max_depth;
+        OST.extensions++;
+    }
 
-        int score = minimax(board, !is_max, depth + 1, alpha, beta, max_depth, player_search);
-        int adj_score = adjust_terminal_score(score, depth);
-        score = adj_score; // corrigir esta atribuição
-        board.undo_move(undo);
+    // Jogada da TT (ou do IID) primeiro; o resto mantém a ordem heurística
+    const int n_children = static_cast<int>(successors.size());
+    std::array<int, 8> order{};
+    for (int i = 0; i < n_children; ++i) order[i] = i;
+    if (tt_move.first >= 0) {
+        for (int i = 1; i < n_children; ++i) {
+            if (successors[i] == tt_move) {
+                std::rotate(order.begin(), order.begin() + i, order.begin() + i + 1);
+                break;
+            }
+        }
+    }
+    const int alpha0 = alpha, beta0 = beta;   // janela de entrada (tipo da entrada final na TT)
+    const Board::Move opp_goal = is_max ? Board::Move{0, board.get_cols() - 1}
+                                        : Board::Move{board.get_rows() - 1, 0};
+    const Board::Move own_goal = is_max ? Board::Move{board.get_rows() - 1, 0}
+                                        : Board::Move{0, board.get_cols() - 1};
+
+    for (int oi = 0; oi < n_children; ++oi) {
+        const auto& ms = successors[order[oi]];
+        if (track_pv && depth + 1 < kMaxPly) pv_len[depth + 1] = 0;
+
+        int score;
+        // Ameaça: entrar no objetivo adversário ou ficar ao lado dele perde já;
+        // só as jogadas que travam a ameaça são exploradas.
+        const bool gives_goal = use_goal_threats &&
+            (ms == opp_goal ||
+             board.threatens_goal(ms.first, ms.second, /*max_goal=*/!is_max));
+        // Linha forçada fechada (beco sem saída): resultado conhecido sem descer.
+        // Par = o adversário fica bloqueado primeiro; ímpar = derrota de quem joga.
+        int line = (!gives_goal && use_corridor_macros) ? board.forced_line_after(ms) : -1;
+        if (gives_goal) {
+            const int loss_depth = (ms == opp_goal) ? depth : depth + 1;
+            score = adjust_terminal_score(is_max ? -1000 : 1000, loss_depth);
+            OST.threat_prunes++;
+        } else if (line >= 0) {
+            const bool mover_wins = (line % 2 == 0);
+            const int mag = 1000 - (depth + line);
+            score = (mover_wins == is_max) ? mag : -mag;
+            OST.dead_ends++;
+        } else {
+            // LMR: filhos tardios e sem ameaça ao próprio objetivo são procurados
+            // primeiro a menor profundidade e janela nula; só se baterem a
+            // janela (alpha para MAX, beta para MIN) se repete a procura completa.
+            int reduction = 0;
+            if (use_lmr && child_idx > 0 && ms != own_goal &&
+                !board.threatens_goal(ms.first, ms.second, /*max_goal=*/is_max)) {
+                reduction = lmr_reduction(board, required, child_idx);
+            }
+            Board::MoveUndo undo = board.apply_move(ms);
+            bool full = true;
+            if (reduction > 0) {
+                OST.lmr_reductions++;
+                const int lo = is_max ? alpha : beta - 1;
+                score = minimax(board, !is_max, depth + 1, lo, lo + 1, child_max_depth - reduction, player_search);
+                score = adjust_terminal_score(score, depth);
+                full = is_max ? score > alpha : score < beta;
+                if (full) OST.lmr_researches++;
+            }
+            if (full) {
+                score = minimax(board, !is_max, depth + 1, alpha, beta, child_max_depth, player_search);
+                score = adjust_terminal_score(score, depth);
+            }
+            board.undo_move(undo);
+        }
         expanded_child = true;
 
         if (debug_level >= 2 && depth <= 1 && debug_level < 3) {
-            LogMsgs::out() << "RS (" << ms.move.first << "," << ms.move.second
+            LogMsgs::out() << "RS (" << ms.first << "," << ms.second
                              << ") -> " << score << "\n";
         }
 
         if (debug_level >= 3) {
-            bool last_child = (&ms == &successors.back());
+            bool last_child = (oi == n_children - 1);
             LogMsgs::out() << branch_prefix(depth, last_child)
-                             << "(" << ms.move.first << ", " << ms.move.second << ") "
+                             << "(" << ms.first << ", " << ms.second << ") "
                              << score << "\n";
         }
 
@@ -636,8 +1441,9 @@ int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int m
                 OST.cutoffs++;
                 OST.cutoff_idx_sum += child_idx;
                 if (child_idx == 0) OST.cutoff_first_child++;
+                if (iid_move && ms == tt_move) OST.iid_move_best++;
 
-                TTEntry e{ score, required, TTBound::Lower };
+                TTEntry e{ score, required, TTBound::Lower, ms };
                 tt_store(e);
                 if (debug_level >= 5) {
                     LogMsgs::out() << "[save] key=" << key_label()
@@ -647,7 +1453,10 @@ int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int m
                 return score;
             }
             alpha = std::max(alpha, score);
-            best  = std::max(best,  score);
+            if (score > best) {
+                best = score; best_move = ms; best_idx = child_idx;
+                if (track_pv) pv_splice(depth, &ms, 1);
+            }
         } else {
             if (score <= alpha) {
                 prunes++;
@@ -655,13 +1464,14 @@ int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int m
                 OST.cutoffs++;
                 OST.cutoff_idx_sum += child_idx;
                 if (child_idx == 0) OST.cutoff_first_child++;
+                if (iid_move && ms == tt_move) OST.iid_move_best++;
 
                 if (debug_level >= 4) {
                     LogMsgs::out() << indent_rails(depth)
                                      << "alpha cut: " << score << "\n";
                 }
 
-                TTEntry e{ score, required, TTBound::Upper };
+                TTEntry e{ score, required, TTBound::Upper, ms };
                 tt_store(e);
                 if (debug_level >= 5) {
                     LogMsgs::out() << "[save] key=" << key_label()
@@ -672,7 +1482,10 @@ int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int m
                 return score;
             }
             beta = std::min(beta, score);
-            best = std::min(best, score);
+            if (score < best) {
+                best = score; best_move = ms; best_idx = child_idx;
+                if (track_pv) pv_splice(depth, &ms, 1);
+            }
         }
         child_idx++;
     }
@@ -685,14 +1498,22 @@ int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int m
     if (!had_cutoff && best_idx >= 0) {
         OST.no_cutoff_nodes++;
         OST.best_idx_sum += best_idx;
+        if (iid_move && best_move == tt_move) OST.iid_move_best++;
     }
 
-    TTEntry e{ best, required, TTBound::Exact };
+    // Sem corte: o valor só é exato se ficou dentro da janela de entrada; fora
+    // dela (fail-low de MAX / fail-high de MIN) é apenas um limite.
+    const TTBound final_bound = best <= alpha0 ? TTBound::Upper
+                              : best >= beta0  ? TTBound::Lower
+                                               : TTBound::Exact;
+    TTEntry e{ best, required, final_bound, best_move };
     tt_store(e);
     if (debug_level >= 5) {
         LogMsgs::out() << "[save] key=" << key_label()
                          << " d_req=" << required
-                         << " val=" << best << " (final, Exact)\n";
+                         << " val=" << best << " (final, "
+                         << (final_bound == TTBound::Exact ? "Exact" : final_bound == TTBound::Lower ? "Lower" : "Upper")
+                         << ")\n";
     }
 
     return best;
@@ -701,7 +1522,7 @@ int AI::minimax(Board& board, bool is_max, int depth, int alpha, int beta, int m
 
 #if defined(RASTROS_MINIMAX_NO_PRUNE)// para debug sem poda alfa-beta(não entra em produção)
 int AI::minimax_no_pruning(Board board, bool is_max, int depth, int max_depth, int player_search) {
-    vs_lookups++;
+    ctx->vs_lookups++;
     eval_successors++;
 
     // ----- TERMINAL ---------------------------------------------------------
@@ -719,7 +1540,7 @@ int AI::minimax_no_pruning(Board board, bool is_max, int depth, int max_depth, i
 
     // ----- INTERNAL NODE EXPANSION (NO ORDERING: iterate raw valid moves) ----
     const auto pos = board.get_marker();
-    const auto moves = board.get_valid_moves(); // raw generation order, no ordering applied
+    const auto moves = board.valid_move_list().decode(pos); // raw generation order, no ordering applied
 
     auto& OST = stats_for(is_max);
     OST.nodes++;
@@ -751,7 +1572,7 @@ int AI::minimax_no_pruning(Board board, bool is_max, int depth, int max_depth, i
                              << ") -> " << adj_score << "\n";
         }
         if (debug_level >= 3) {
-            bool last_child = (&mv == &moves.back());
+            bool last_child = (&mv == moves.end() - 1);
             LogMsgs::out() << branch_prefix(depth, last_child)
                              << "(" << mv.first << ", " << mv.second << ") "
                              << adj_score << "\n";
@@ -778,7 +1599,7 @@ int AI::minimax_noTT(Board board,
                 int player_search)
 {
     eval_successors++;
-    vs_lookups++;
+    ctx->vs_lookups++;
 
     // ----- TERMINAL ---------------------------------------------------------
     if (board.is_terminal()) {
@@ -787,17 +1608,14 @@ int AI::minimax_noTT(Board board,
     }
 
     // ----- DEPTH LIMIT / QUIESCENCE FRONTIER -------------------------------
-    const bool use_quiescence = false;
-
     if (depth >= max_depth) {
         if (use_quiescence) {
             if (debug_level >= 2) {
                 LogMsgs::out() << "[Q] entering quiescence at depth=" << depth << "\n";
             }
 
-            int qval = quiescence(board, is_max, alpha, beta, /*qdepth=*/0, /*base_depth=*/depth);
-
-            // [NOTE] If you enable quiescence, consider storing TT here similarly (bound-aware).
+            int qval = quiescence(board, is_max, alpha, beta, /*qdepth=*/0, /*base_depth=*/depth,
+                                  player_search);
             return qval;
         } else {
             // Heuristic evaluation frontier
@@ -834,7 +1652,7 @@ int AI::minimax_noTT(Board board,
         LogMsgs::out() << indent_rails(depth)
                          << "(" << pos.first << "," << pos.second << ")->";
         for (const auto& ms : successors) {
-            LogMsgs::out() << "(" << ms.move.first << ", " << ms.move.second << "), ";
+            LogMsgs::out() << "(" << ms.first << ", " << ms.second << "), ";
         }
         LogMsgs::out() << "eval [" << opponent << "] position to [" << player << "]\n";
     }
@@ -850,7 +1668,7 @@ int AI::minimax_noTT(Board board,
 
     for (const auto& ms : successors) {
         Board tmp = board;
-        tmp.make_move(ms.move);
+        tmp.make_move(ms);
 
         int score = minimax_noTT(tmp, !is_max, depth + 1, alpha, beta, max_depth, player_search);
 
@@ -858,13 +1676,13 @@ int AI::minimax_noTT(Board board,
         score = adj_score; // keep representation consistent with stores (see frontier note)
 
         if (debug_level >= 2 && depth <= 1 && debug_level < 3) {
-            LogMsgs::out() << "RS (" << ms.move.first << "," << ms.move.second
+            LogMsgs::out() << "RS (" << ms.first << "," << ms.second
                              << ") -> " << score << "\n";
         }
         if (debug_level >= 3) {
             bool last_child = (&ms == &successors.back());
             LogMsgs::out() << branch_prefix(depth, last_child)
-                             << "(" << ms.move.first << ", " << ms.move.second << ") "
+                             << "(" << ms.first << ", " << ms.second << ") "
                              << adj_score << "\n";
         }
 
@@ -925,6 +1743,32 @@ int AI::minimax_noTT(Board board,
 }
 #endif
 
+// BFS só quando o marcador está a <= 2 casas (Chebyshev) de um objetivo:
+// a distância real nunca é menor do que essa
+bool AI::goal_race_near(const Board& board) {
+    const auto mk = board.get_marker();
+    const int to_max = std::max(std::abs(mk.first - (board.get_rows() - 1)), std::abs(mk.second));
+    const int to_min = std::max(std::abs(mk.first), std::abs(mk.second - (board.get_cols() - 1)));
+    if (to_max > 2 && to_min > 2) return false;
+    const auto reach = board.compute_distance();
+    return -reach.h1 <= 2 || reach.h5 <= 2;
+}
+
+bool AI::single_move(const Board& board, Board::Move& out) {
+    static const int dr[8] = {-1,-1,-1, 0, 0, 1, 1, 1};
+    static const int dc[8] = {-1, 0, 1,-1, 1,-1, 0, 1};
+    const auto& g = board.grid_ref();
+    const auto mk = board.get_marker();
+    int cnt = 0;
+    for (int i = 0; i < 8; ++i) {
+        int r = mk.first + dr[i], c = mk.second + dc[i];
+        if (r < 0 || r >= board.get_rows() || c < 0 || c >= board.get_cols() || g[r][c] != 1) continue;
+        if (++cnt > 1) return false;
+        out = {r, c};
+    }
+    return cnt == 1;
+}
+
 int AI::adjust_terminal_score(int score, int depth) {
     // - Quando detetados estados terminais (±1000), ajusta-se a pontuação
     // pela profundidade, preferindo vitórias mais rápidas e derrotas mais tardias
@@ -942,7 +1786,7 @@ int AI::evaluate_terminal(const Board& board, bool is_max) {
     auto mk = board.get_marker();
     if (mk == std::make_pair(board.get_rows() - 1, 0)) return 1000;
     if (mk == std::make_pair(0, board.get_cols() - 1)) return -1000;
-    if (board.get_valid_moves().empty()) return is_max ? -1000 : 1000;
+    if (board.valid_move_list().empty()) return is_max ? -1000 : 1000;
     return 0;
 }
 
@@ -993,7 +1837,7 @@ int AI::default_heuristic(const Board& board, bool is_max) {
 // - Gera a lista de sucessores e ordena pela heuristica
 // - Aplica um dos tipos de ordenação (Deterministic, ShuffleAll, NoisyJitter)
 // para experimentação e criação de variedade em torneios.
-// - Usa uma cache local (s_order_cache) indexada pelo estado + tipo para
+// - Usa uma cache local (ctx->order_cache) indexada pelo estado + tipo para
 // evitar recalcular na mesma raiz.
 // * ShuffleAll: ignora scores, baralha completamente.
 // * NoisyJitter: adiciona ruído gaussiano pequeno aos scores, ordena estável.
@@ -1002,43 +1846,36 @@ int AI::default_heuristic(const Board& board, bool is_max) {
 // - Opcionalmente baralha apenas grupos de empates.
 // ----------------------------------------------------------------------------
 
-const std::vector<MoveScore>& AI::ordered_children(Board& board, bool is_max, int depth, int /*max_depth*/, int player_search) {
+MoveList::Decoded AI::ordered_children(Board& board, bool is_max, int depth, int /*max_depth*/, int player_search) {
     CompactOrderKey ckey{board.get_hash(), depth, is_max, player_search,
                          static_cast<uint8_t>(ordering_policy),
                          board.get_marker().first, board.get_marker().second};
-    if (auto it = s_order_cache.find(ckey); it != s_order_cache.end()) return it->second;
-
-    // Constrói a lista de sucessores avaliados uma única vez
-    std::vector<MoveScore> out;
-    auto moves = board.get_valid_moves();
-    out.reserve(moves.size());
-
-
-    for (const auto& mv : moves) {
-            
-        Board tmp = board;
-        tmp.make_move(mv);
-        int s = total_heuristic(tmp, is_max); // coloca no cache mais tarde em folhas por s_heuristic_cache
-        // std::cout <<"("<< mv.first<<","<<mv.second<<") ->"<<s<<"\n";
-        out.push_back({mv, s});
+    const auto marker = board.get_marker();
+    auto& order_cache = ctx->order_cache;
+    if (auto it = order_cache.find(ckey); it != order_cache.end()) return it->second.decode(marker);
+
+    // Constrói a lista de sucessores avaliados uma única vez (scores só para ordenar)
+    std::array<MoveScore, MoveList::kMaxMoves> buf;
+    int n = 0;
+    for (const auto& mv : board.valid_move_list().decode(marker)) {
+        // no próprio tabuleiro (sem cópia da grelha): apply_move + jogador de volta = make_move
+        const Board::MoveUndo undo = board.apply_move(mv);
+        board.switch_player();
+        int s = total_heuristic(board, is_max); // coloca no cache mais tarde em folhas por ctx->heuristic_cache
+        board.undo_move(undo);
+        buf[n++] = {mv, s};
     }
+    auto out_begin = buf.begin();
+    auto out_end = buf.begin() + n;
 
     //Aplicar politica de ordenamento
     if (ordering_policy == OrderingPolicy::ShuffleAll) {
         // Ignora scores, baralha completamente
-        #ifdef RASTROS_TESTS
-          auto& gen = test_rng();
-        #else
-          std::random_device rd; std::mt19937 gen(rd());
-        #endif
-        std::shuffle(out.begin(), out.end(), gen);
+        auto& gen = rng();
+        std::shuffle(out_begin, out_end, gen);
     } else if (ordering_policy == OrderingPolicy::NoisyJitter) {
         // Heurística + ruído gaussiano pequeno, depois ordenação estável
-        #ifdef RASTROS_TESTS
-          auto& gen = test_rng();
-        #else
-          std::random_device rd; std::mt19937 gen(rd());
-        #endif
+        auto& gen = rng();
         std::normal_distribution<double> noise(0.0, order_noise_sigma);
 
         // Pré-computa ruído por jogada (para comparador estável)
@@ -1046,9 +1883,10 @@ const std::vector<MoveScore>& AI::ordered_children(Board& board, bool is_max, in
             return (static_cast<uint64_t>(static_cast<uint32_t>(m.first)) << 32)
                  ^ static_cast<uint32_t>(m.second);
         };
-        std::unordered_map<uint64_t,double> nmap;
-        nmap.reserve(out.size());
-        for (auto& ms : out) nmap.emplace(move_key(ms.move), noise(gen));
+        SearchArena::Frame frame;
+        std::pmr::unordered_map<uint64_t,double> nmap(SearchArena::current());
+        nmap.reserve(n);
+        for (auto it = out_begin; it != out_end; ++it) nmap.emplace(move_key(it->move), noise(gen));
 
         auto cmpMax = [&](const MoveScore& a, const MoveScore& b) {
             double ka = static_cast<double>(a.score) + nmap[move_key(a.move)];
@@ -1066,48 +1904,51 @@ const std::vector<MoveScore>& AI::ordered_children(Board& board, bool is_max, in
             return a.move.second < b.move.second;
         };
 
-        if (is_max) std::stable_sort(out.begin(), out.end(), cmpMax);
-        else        std::stable_sort(out.begin(), out.end(), cmpMin);
+        if (is_max) std::stable_sort(out_begin, out_end, cmpMax);
+        else        std::stable_sort(out_begin, out_end, cmpMin);
 
         // Opcional: baralha apenas empates de score base - aplica-se a qualquer politica escolhida
         if (shuffle_ties_only) {
-            #ifdef RASTROS_TESTS
-              auto& gen2 = test_rng();
-            #else
-              std::random_device rd2; std::mt19937 gen2(rd2());
-            #endif
-            size_t i = 0;
-            while (i < out.size()) {
-                size_t j = i + 1;
-                while (j < out.size() && out[j].score == out[i].score) ++j;
-                if (j - i > 1) std::shuffle(out.begin() + i, out.begin() + j, gen2);
+            auto& gen2 = rng();
+            int i = 0;
+            while (i < n) {
+                int j = i + 1;
+                while (j < n && buf[j].score == buf[i].score) ++j;
+                if (j - i > 1) std::shuffle(buf.begin() + i, buf.begin() + j, gen2);
                 i = j;
             }
         }
 
     } else { // Deterministic
-        if (is_max) std::sort(out.begin(), out.end(), MoveScoreCmpMax{});
-        else        std::sort(out.begin(), out.end(), MoveScoreCmpMin{});
+        // ordenação por inserção (≤ 8 elementos; ordem total, igual a std::sort)
+        auto insertion_sort = [&](auto better) {
+            for (int i = 1; i < n; ++i) {
+                const MoveScore x = buf[i];
+                int j = i - 1;
+                while (j >= 0 && better(x, buf[j])) { buf[j + 1] = buf[j]; --j; }
+                buf[j + 1] = x;
+            }
+        };
+        if (is_max) insertion_sort(MoveScoreCmpMax{});
+        else        insertion_sort(MoveScoreCmpMin{});
 
         if (shuffle_ties_only) {
-            #ifdef RASTROS_TESTS
-              auto& gen = test_rng();
-            #else
-              std::random_device rd; std::mt19937 gen(rd());
-            #endif
-            size_t i = 0;
-            while (i < out.size()) {
-                size_t j = i + 1;
-                while (j < out.size() && out[j].score == out[i].score) ++j;
-                if (j - i > 1) std::shuffle(out.begin() + i, out.begin() + j, gen);
+            auto& gen = rng();
+            int i = 0;
+            while (i < n) {
+                int j = i + 1;
+                while (j < n && buf[j].score == buf[i].score) ++j;
+                if (j - i > 1) std::shuffle(buf.begin() + i, buf.begin() + j, gen);
                 i = j;
             }
         }
     }
 
-    // coloca resultado na cache e devolve referência
-    auto [ins, _] = s_order_cache.emplace(ckey, std::move(out));
-    return ins->second;
+    // na cache fica só a ordem (direções compactas, 4 bytes por posição)
+    MoveList packed;
+    for (int i = 0; i < n; ++i) packed.push_back(PackedMove::between(marker, buf[i].move));
+    order_cache.emplace(ckey, packed);
+    return packed.decode(marker);
 }
 
 
@@ -1116,27 +1957,77 @@ const std::vector<MoveScore>& AI::ordered_children(Board& board, bool is_max, in
 
 //////////////////////////////////////////////////////////////////////////
 
-//quiescence-search -> implementada mas não activada, precisa verificação/testes
+// Avaliação de folha com cache por raiz (ctx->heuristic_cache).
+// Partilhada pelo minimax (horizonte) e pelo stand-pat da quiescence.
+int AI::leaf_heuristic(const Board& board, bool is_max, int max_depth, int player_search) {
+    auto mk_leaf = board.get_marker();
+    CompactHeuristicKey chk{board.get_hash(), is_max, max_depth, player_search,
+                            mk_leaf.first, mk_leaf.second};
+    auto& heuristic_cache = ctx->heuristic_cache;
+    if (auto it = heuristic_cache.find(chk); it != heuristic_cache.end()) {
+        return it->second;
+    }
+    int val = total_heuristic(board, is_max);
+    heuristic_cache[chk] = val;
+    return val;
+}
+
+//quiescence-search
 // ----------------------------------------------------------------------------
-// - (q-search) para reduzir efeito de horizonte.
-// - Extende apenas em posições "ruidosas" (precisam de ser melhor definidas).
-// - Mantém avaliação estática (stand-pat) e aplica cortes alfa–beta.
+// - (q-search) para reduzir efeito de horizonte junto aos objetivos.
+// - Extende apenas em posições "ruidosas": teste O(1) por Chebyshev aos
+// objetivos (limite inferior da distância real, sem BFS).
+// - Mantém avaliação estática (stand-pat, via cache de folhas) e aplica
+// cortes alfa–beta.
+// - make/unmake (apply_move/undo_move) em vez de cópias do tabuleiro.
+// - Features dos sucessores calculadas uma vez (gen_quiescence_moves) e
+// reutilizadas na ordenação; jogadas para junto do objetivo livre do
+// adversário são descartadas (se forem todas, o nó é uma derrota).
+// - TT própria (qtt) com profundidade = plies de quiescence restantes.
 // - qdepth limita a profundidade de extensão; base_depth é a profundidade
 // do nó de onde partiu a chamada (para ajustar scores terminais).
-// - só explora um subconjunto de jogadas consideradas ruidosas
 // ----------------------------------------------------------------------------
 
-int AI::quiescence(Board board, bool is_max, int alpha, int beta, int qdepth, int base_depth) {
-    
-    //Teste terminal (pode acontecer no horizonte)
-    if (board.is_terminal()) {
-        int t = evaluate_terminal(board, is_max);
-        return adjust_terminal_score(t, base_depth + qdepth);
+int AI::quiescence(Board& board, bool is_max, int alpha, int beta, int qdepth, int base_depth,
+                   int player_search) {
+    eval_successors++;
+    budget_nodes++;
+    last_max_depth_reached = std::max(last_max_depth_reached, base_depth + qdepth);
+
+    // Teste terminal barato (pode acontecer no horizonte)
+    const auto mk = board.get_marker();
+    if (mk == std::make_pair(board.get_rows() - 1, 0)) return 1000;
+    if (mk == std::make_pair(0, board.get_cols() - 1)) return -1000;
+
+    std::array<QuiescenceChild, 8> kids;
+    int legal = 0, losing = 0;
+    const int n_noisy = gen_quiescence_moves(board, is_max, kids, legal, losing);
+    if (legal == 0) return is_max ? -1000 : 1000; // sem jogadas: quem joga perde
+    // todas as jogadas deixam o objetivo livre ao alcance do adversário:
+    // derrota no ply seguinte, não um stand-pat
+    if (losing == legal) return adjust_terminal_score(is_max ? -1000 : 1000, base_depth + qdepth + 1);
+
+    CompactStateKey key = compact_state_key(board, is_max, player_search);
+    const int remaining = q_max_plies - qdepth;
+    if (auto it = qtt.find(key); it != qtt.end() && it->second.depth >= remaining) {
+        const TTEntry& cached = it->second;
+        if (cached.bound == TTBound::Exact) return cached.value;
+        if (cached.bound == TTBound::Lower && cached.value >= beta)  return cached.value;
+        if (cached.bound == TTBound::Upper && cached.value <= alpha) return cached.value;
     }
 
     // Stand‑pat: avaliação estática da posição corrente
     // (perspetiva = lado que joga neste nó)
-    int stand_pat = total_heuristic(board, is_max);
+    int stand_pat = leaf_heuristic(board, is_max, base_depth, player_search);
+
+    //posição é "sossegada" / limite de profundidade / nada de tático
+    if (qdepth >= q_max_plies || n_noisy == 0 ||
+        (legal > q_low_mob && is_quiet_position(board))) {
+        return stand_pat;
+    }
+
+    const int alpha_orig = alpha;
+    const int beta_orig  = beta;
 
     // Alfa–beta sobre o stand‑pat
     if (is_max) {
@@ -1147,113 +2038,113 @@ int AI::quiescence(Board board, bool is_max, int alpha, int beta, int qdepth, in
         if (beta > stand_pat) beta = stand_pat;
     }
 
-    // Métrica base para decidir "ruído" (uma só vez)
-    auto reach = board.compute_distance();
-    int base_h1 = reach.h1;
-    int base_h5 = reach.h5;
-
-    //posição é "sossegada" / limite de profundidade
-    if (qdepth >= q_max_plies || is_quiet_position(board, base_h1, base_h5)) {
-        return stand_pat;
-    }
-
-    // Geração de jogadas "ruidosas" (táticas)
-    auto qmoves = gen_quiescence_moves(board, is_max, base_h1, base_h5);
-    if (qmoves.empty()) return stand_pat; // nada de relevante: devolve stand‑pat
-
-    //Exploração barata (best‑first leve é aplicado dentro do gerador)
-    int best = is_max ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
-
-    for (const auto& mv : qmoves) {
-        Board tmp = board;
-        tmp.make_move(mv);
-
-        int score = quiescence(tmp, !is_max, alpha, beta, qdepth + 1, base_depth);
-        // Ajuste por profundidade total até aqui
-        score = adjust_terminal_score(score, base_depth + qdepth + 1);
+    int best = stand_pat;
+    for (int i = 0; i < n_noisy; ++i) {
+        const auto& qc = kids[i];
+        int score;
+        if (qc.wins) {
+            // vitória imediata: não é preciso descer
+            score = adjust_terminal_score(is_max ? 1000 : -1000, base_depth + qdepth);
+        } else {
+            Board::MoveUndo undo = board.apply_move(qc.move);
+            score = quiescence(board, !is_max, alpha, beta, qdepth + 1, base_depth, player_search);
+            board.undo_move(undo);
+            // Ajuste por profundidade total até aqui
+            score = adjust_terminal_score(score, base_depth + qdepth);
+        }
 
         if (is_max) {
             if (score > best) best = score;
-            if (best >= beta) return best;     // cutoff
+            if (best >= beta) break;     // cutoff
             if (alpha < best) alpha = best;
         } else {
             if (score < best) best = score;
-            if (best <= alpha) return best;    // cutoff
+            if (best <= alpha) break;    // cutoff
             if (beta > best) beta = best;
         }
     }
 
+    TTBound bound = TTBound::Exact;
+    if (best >= beta_orig)       bound = TTBound::Lower;
+    else if (best <= alpha_orig) bound = TTBound::Upper;
+    qtt[key] = TTEntry{ best, remaining, bound };
+
     return best;
 }
 
 // ----------------------------------------------------------------------------
 // - Determina se uma posição é "calma" (sem ameaças imediatas).
-// - Considera ruidosa se algum objetivo está a ≤1 jogada de distância.
-// - Caso ambos os caminhos estejam bloqueados longe (900 = inalcançável),
-// assume-se como quieta.
+// - Ruidosa se o marcador está a ≤ q_swing_delta (Chebyshev) de algum
+// objetivo: como Chebyshev é um limite inferior do caminho real, posições
+// longe dos dois objetivos nunca têm ameaças dentro desse raio.
 // ----------------------------------------------------------------------------
-bool AI::is_quiet_position(const Board& board, int base_h1, int base_h5) {
-    // "Calma"se não houver vitórias iminentes nem sinais triviais de
-    // bloqueio imediato -  ruidosa se qualquer objetivo estiver a 1.
-    if (std::abs(base_h1) <= 1) return false;
-    if (std::abs(base_h5) <= 1) return false;
-
-    // Se ambos os caminhos estão bloqueados consider-se  como quieta.
-    // (900 é o valor de inalcançável no cálculo de reachability.)
+bool AI::is_quiet_position(const Board& board) const {
+    const auto mk = board.get_marker();
+    if (::h_distance(board, mk, /*is_max=*/true)  <= q_swing_delta) return false;
+    if (::h_distance(board, mk, /*is_max=*/false) <= q_swing_delta) return false;
     return true;
 }
 
 // ----------------------------------------------------------------------------
-// - Gera subconjunto de jogadas "ruidosas" para q-search.
+// - Gera subconjunto de jogadas "ruidosas" para q-search, sem alocações.
+// - 'legal' devolve o nº total de jogadas válidas (0 -> terminal).
 // - Critérios para marcar jogada como ruidosa:
-// * near_goal: aproximação imediata a objetivo (≤1 jogada).
-// * big_swing: grande diferença na distância até objetivo vs base.
+// * wins: entra no objetivo de quem joga.
+// * near_goal: aterra a ≤ q_swing_delta de um objetivo.
 // * low_reply: baixa mobilidade de resposta do adversário (jogada forçante).
-// - Opcionalmente ordena estas jogadas de forma barata para potenciar cortes.
+// - Jogadas que deixam o adversário a um passo do seu objetivo são perdas
+// conhecidas e ficam de fora (o stand-pat já cobre a alternativa).
+// - Ordena (vitórias, menor mobilidade de resposta, mais perto do objetivo)
+// usando as features já calculadas.
 // ----------------------------------------------------------------------------
-std::vector<std::pair<int,int>> AI::gen_quiescence_moves(const Board& board, bool is_max,
-                                                         int base_h1, int base_h5) {
-
-    // Seleciona apenas jogadas com potencial tático imediato
-    std::vector<std::pair<int,int>> noisy;
-    auto moves = board.get_valid_moves();
-    noisy.reserve(moves.size());
-
-    for (const auto& mv : moves) {
-        Board tmp = board;
-        tmp.make_move(mv);
-
-        // Reachability após a jogada
-        auto r2 = tmp.compute_distance();
-        int h1p = r2.h1;
-        int h5p = r2.h5;
-
-        bool near_goal = (std::abs(h1p) <= 1) || (std::abs(h5p) <= 1);
-        bool big_swing = (std::abs(h1p - base_h1) >= q_swing_delta) ||
-                         (std::abs(h5p - base_h5) >= q_swing_delta);
-
-        // Mobilidade de resposta do oponente
-        int opp_moves = (int)tmp.get_valid_moves().size();
-        bool low_reply = (opp_moves <= q_low_mob);
-
-        if (near_goal || big_swing || low_reply) {
-            noisy.push_back(mv);
+int AI::gen_quiescence_moves(const Board& board, bool is_max,
+                             std::array<QuiescenceChild, 8>& out, int& legal, int& losing) const {
+    static const int dr[8] = {-1, 1,  0, 0, -1, -1, 1, 1};
+    static const int dc[8] = { 0, 0, -1, 1, -1,  1, -1, 1};
+
+    const int R = board.get_rows(), C = board.get_cols();
+    const auto& g = board.grid_ref();
+    const auto mk = board.get_marker();
+    // a célula do marcador fica bloqueada ao sair; desconta-se na mobilidade
+    const int marker_free = g[mk.first][mk.second] == 1 ? 1 : 0;
+    const std::pair<int,int> own_goal = is_max ? std::make_pair(R - 1, 0) : std::make_pair(0, C - 1);
+    const std::pair<int,int> opp_goal = is_max ? std::make_pair(0, C - 1) : std::make_pair(R - 1, 0);
+
+    int n = 0;
+    legal = losing = 0;
+    for (int i = 0; i < 8; ++i) {
+        const int r = mk.first + dr[i], c = mk.second + dc[i];
+        if (r < 0 || r >= R || c < 0 || c >= C || g[r][c] != 1) continue;
+        legal++;
+
+        QuiescenceChild qc;
+        qc.move = {r, c};
+        qc.wins = (qc.move == own_goal);
+        qc.own_goal = std::max(std::abs(own_goal.first - r), std::abs(own_goal.second - c));
+        const int opp_dist = std::max(std::abs(opp_goal.first - r), std::abs(opp_goal.second - c));
+        qc.reply_mob = board.free_neighbours(r, c) - marker_free;
+
+        if (!qc.wins && opp_dist <= 1 && g[opp_goal.first][opp_goal.second] == 1) {
+            losing++;   // o adversário entra no objetivo a seguir
+            continue;
         }
+
+        const bool near_goal = qc.own_goal <= q_swing_delta || opp_dist <= q_swing_delta;
+        const bool low_reply = qc.reply_mob <= q_low_mob;
+        if (qc.wins || near_goal || low_reply) out[n++] = qc;
     }
 
-    // opcional -> precisa de verificação e testes
-    //ordenação barata (melhora os cortes sem custo excessivo):
-    // prioridade aproximada para lances que melhoram a perspetiva do jogador
-    // ao turno e/ou pioram a do adversário.
-    std::stable_sort(noisy.begin(), noisy.end(), [&](const auto& a, const auto& b){
-        Board ta = board; ta.make_move(a);
-        Board tb = board; tb.make_move(b);
-        auto ra = ta.compute_distance();
-        auto rb = tb.compute_distance();
-        int da = (is_max ? -ra.h1 : ra.h1) + (is_max ? rb.h5 : -ra.h5); 
-        int db = (is_max ? -rb.h1 : rb.h1) + (is_max ? rb.h5 : -rb.h5);
-        return da > db; // best-first leve
-    });
-
-    return noisy;
+    // ordenação por inserção (≤ 8 elementos)
+    auto better = [](const QuiescenceChild& a, const QuiescenceChild& b) {
+        if (a.wins != b.wins) return a.wins;
+        if (a.reply_mob != b.reply_mob) return a.reply_mob < b.reply_mob;
+        return a.own_goal < b.own_goal;
+    };
+    for (int i = 1; i < n; ++i) {
+        QuiescenceChild x = out[i];
+        int j = i - 1;
+        while (j >= 0 && better(x, out[j])) { out[j + 1] = out[j]; --j; }
+        out[j + 1] = x;
+    }
+    return n;
 }
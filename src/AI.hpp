@@ -4,6 +4,12 @@
 #include "Board.hpp"
 #include "HeuristicsUtils.hpp"
 #include "LogMsgs.hpp"
+#include "EndgameSolver.hpp"
+#include "ProofNumberSearch.hpp"
+#include "PerfectPlayDB.hpp"
+#include "OpeningBook.hpp"
+#include "RaceBounds.hpp"
+#include "SearchArena.hpp"
 #include <utility>
 #include <unordered_map>
 #include <vector>
@@ -13,6 +19,13 @@
 #include <algorithm> 
 #include <cstdint>
 #include <chrono>
+#include <memory>
+#include <array>
+#include <atomic>
+#include <random>
+#include <future>
+#include <mutex>
+#include <thread>
 
 
 
@@ -126,7 +139,7 @@ struct TTEntry {
     int value;      // stored score
     int depth;      // search depth this entry is valid for (plies remaining)
     TTBound bound;  // Exact / Lower(α) / Upper(β)
-    // (optional) std::pair<int,int> bestMove;
+    std::pair<int,int> best_move{-1, -1};   // jogada do corte/melhor (ordena a reprocura)
 };
 
 
@@ -168,9 +181,139 @@ struct OrderingStats {
     uint64_t cutoff_idx_sum = 0;     
     uint64_t no_cutoff_nodes = 0;    
     uint64_t best_idx_sum = 0;       
+    uint64_t region_solved = 0;      // nós resolvidos pelo RegionSolver
+    uint64_t corridor_plies = 0;     // plies aplicados em macro-jogadas de corredor
+    uint64_t dead_ends = 0;          // filhos resolvidos como linha forçada fechada
+    uint64_t immediate_wins = 0;     // nós com entrada direta no próprio objetivo
+    uint64_t threat_prunes = 0;      // filhos que deixam o adversário a um passo do objetivo
+    uint64_t mate_cutoffs = 0;       // cortes por limites de distância ao mate
+    uint64_t race_cutoffs = 0;       // cortes por limites da corrida (RaceBounds)
+    uint64_t etc_cutoffs = 0;        // cortes por um filho já na TT (ETC)
+    uint64_t iid_searches = 0;       // procuras reduzidas (IID) em nós sem jogada na TT
+    uint64_t iid_move_best = 0;      // ... cuja jogada acabou por cortar/ser a melhor
+    uint64_t lmr_reductions = 0;     // filhos procurados com profundidade reduzida (LMR)
+    uint64_t lmr_researches = 0;     // reduções que bateram a janela -> repetidas a fundo
+    uint64_t futility_prunes = 0;    // nós de fronteira cortados por futilidade
+    uint64_t razor_prunes = 0;       // nós a 2 plies cortados por razoring
+    uint64_t extensions = 0;         // plies de extensão (resposta única / corrida ao objetivo)
 };
 
 
+// Margens de futilidade/razoring, nas unidades da heurística. Num ply quem
+// joga encurta o próprio caminho (h1/h5) no máximo 1 casa e, em jogo normal,
+// alonga o do adversário em poucas; cortes totais de caminho (±900) e
+// bloqueios da diagonal (±40) ficam fora da margem -> poda seletiva.
+struct FutilityParams {
+    int frontier_margin = 3;   // a 1 ply do horizonte (futilidade)
+    int razor_margin = 3;      // a 2 plies: a resposta do adversário também conta,
+                               // o ganho líquido fica perto do de um ply
+};
+
+// Late Move Reductions: redução R(restantes, índice) = base + ln(restantes) *
+// ln(índice+1) / divisor (arredondada para baixo), para filhos a partir de
+// 'full_moves' e com pelo menos 'min_remaining' plies por procurar.
+struct LMRParams {
+    int full_moves = 3;
+    int min_remaining = 3;
+    double base = 0.5;
+    double divisor = 2.0;
+    // valores por omissão por tamanho de tabuleiro
+    static LMRParams for_board(int rows, int cols);
+};
+
+
+
+// Limites de AI::analyse: profundidade (0 = max_depth) e orçamento de nós (0 = sem limite)
+struct AnalysisLimits {
+    int depth = 0;
+    uint64_t nodes = 0;
+};
+
+// Uma das k melhores jogadas da raiz devolvidas por AI::analyse
+struct RootLine {
+    std::pair<int,int> move{-1, -1};
+    int score = 0;                              // exato, perspetiva de MAX
+    int depth = 0;                              // profundidade nominal da iteração
+    int seldepth = 0;                           // ply mais fundo atingido (quiescence/corredores)
+    std::vector<std::pair<int,int>> pv;         // variante principal, a começar em 'move'
+    uint64_t nodes = 0;                         // nós de minimax/quiescence desta jogada
+};
+
+// Estado de procura de uma AI (antes estático/thread_local e partilhado por
+// todas as instâncias da thread): caches de ordenação e de heurística das
+// folhas, contadores da TT, o turno da última choose_move e a arena.
+struct SearchContext {
+    std::unordered_map<CompactOrderKey, MoveList> order_cache;   // ordem compacta dos filhos
+    std::unordered_map<CompactHeuristicKey, int> heuristic_cache;
+    uint64_t vs_lookups = 0;
+    uint64_t vs_hits = 0;
+    uint64_t vs_inserts = 0;
+    int count_visited = 0;
+    int rounds = 0;
+    SearchArena arena;   // scratch da procura (reposta a cada choose_move/analyse)
+
+    void reset_counters() { vs_lookups = vs_hits = vs_inserts = 0; count_visited = 0; }
+};
+
+// Posse do SearchContext: cada AI tem o seu e uma cópia da AI copia-o (a
+// cópia pode correr noutra thread); a partilha só por AI::share_search_context.
+class SearchContextRef {
+public:
+    SearchContextRef() : ctx(std::make_shared<SearchContext>()) {}
+    SearchContextRef(const SearchContextRef& o) : ctx(std::make_shared<SearchContext>(*o.ctx)) {}
+    SearchContextRef& operator=(const SearchContextRef& o) {
+        if (this != &o) ctx = std::make_shared<SearchContext>(*o.ctx);
+        return *this;
+    }
+    SearchContextRef(SearchContextRef&&) noexcept = default;
+    SearchContextRef& operator=(SearchContextRef&&) noexcept = default;
+
+    SearchContext* operator->() const { return ctx.get(); }
+    SearchContext& operator*() const { return *ctx; }
+    void share(const SearchContextRef& o) { ctx = o.ctx; }
+    bool shared_with(const SearchContextRef& o) const { return ctx == o.ctx; }
+
+private:
+    std::shared_ptr<SearchContext> ctx;
+};
+
+// Limites de AI::start_search: profundidade (0 = max_depth), nós e tempo (0 = sem
+// limite); 'rounds' é o mesmo de choose_move
+struct SearchLimits {
+    int depth = 0;
+    uint64_t nodes = 0;
+    int time_ms = 0;
+    int rounds = 0;
+};
+
+// Progresso no fim de cada iteração completa de choose_move/start_search
+struct SearchProgress {
+    int depth = 0;
+    int score = 0;                              // perspetiva de MAX
+    uint64_t nodes = 0;
+    double nps = 0.0;
+    std::pair<int,int> best_move{-1, -1};
+    std::vector<std::pair<int,int>> pv;
+};
+
+struct SearchResult {
+    std::pair<int,int> move{-1, -1};
+    int score = 0;                              // perspetiva de MAX
+    int depth = 0;                              // última iteração completa
+    uint64_t nodes = 0;
+    bool stopped = false;                       // parada (stop/tempo/nós) antes da profundidade pedida
+};
+
+// Pedido de paragem cooperativa da procura (ponder, pesquisa assíncrona).
+// Copiável para que AI continue a poder ser copiada/atribuída: a cópia
+// começa sempre sem pedido pendente.
+struct SearchStop {
+    std::atomic<bool> requested{false};
+    SearchStop() = default;
+    SearchStop(const SearchStop&) {}
+    SearchStop& operator=(const SearchStop&) { requested.store(false); return *this; }
+};
+
 
 class AI {
 public:
@@ -186,8 +329,88 @@ public:
         use_quiescence = enabled; q_max_plies = max_plies;
         q_swing_delta = swing_delta; q_low_mob = low_mob;
     }
+    // Solver exato quando ambos os objetivos ficam inalcançáveis
+    void set_region_solver(bool enabled) { use_region_solver = enabled; }
+    // Macro-jogadas em corredores e corte de becos sem saída
+    void set_corridor_macros(bool enabled) { use_corridor_macros = enabled; }
+    // Deteção de ameaças ao objetivo + limites de distância ao mate
+    void set_goal_threats(bool enabled) { use_goal_threats = enabled; }
+    // Limites provados da corrida aos objetivos (RaceBounds); exatos, ligados por omissão
+    void set_race_bounds(bool enabled) { use_race_bounds = enabled; }
+    // Enhanced transposition cutoffs: TT dos filhos antes de expandir (ligado por omissão)
+    void set_etc(bool enabled) { use_etc = enabled; }
+    // Internal iterative deepening: nós com >= min_remaining plies e sem jogada na TT
+    // fazem primeiro uma procura a (restante - reduction) para ordenar (ligado por omissão)
+    void set_iid(bool enabled, int min_remaining = 6, int reduction = 2) {
+        use_iid = enabled; iid_min_remaining = min_remaining; iid_reduction = reduction;
+    }
+    // Solver exato (proof-number search): vitória/derrota forçada de quem joga
+    // em 'board', com a jogada que prova a vitória; Unknown se esgotar node_budget.
+    ProofNumberSolver::Verdict solve(const Board& board, uint64_t node_budget);
+    // Modo vitória/derrota: aprofundamento iterativo com janelas nulas à volta de 0
+    // (MTD(f) na escala de evaluate_terminal); a heurística só ordena. Mesma
+    // resposta que solve(); Unknown se esgotar node_budget (0 = sem limite).
+    ProofNumberSolver::Verdict solve_wl(const Board& board, uint64_t node_budget = 0);
+    // Consulta da base de dados de jogo perfeito (5x5/6x6) antes de procurar.
+    // Desligada por omissão: os torneios entre heurísticas não podem depender
+    // dos ficheiros em data/; o jogo interativo e os bindings ligam-na.
+    void set_perfect_db(bool enabled) { use_perfect_db = enabled; }
+    // Consulta do livro de aberturas (mmap) antes de procurar. Desligada por
+    // omissão como a BD: o livro é gerado com default_heuristic, e as outras
+    // combinações jogariam as mesmas aberturas.
+    void set_opening_book(bool enabled) { use_opening_book = enabled; }
+    // Score da última decisão de choose_move (perspetiva de MAX)
+    int last_score() const { return last_best_score; }
+    // Futilidade (1 ply) e razoring (2 plies) junto ao horizonte (desligados por omissão)
+    void set_futility(bool enabled, const FutilityParams& p = FutilityParams{}) {
+        use_futility = enabled; futility = p;
+    }
+    // Late Move Reductions (desligadas por omissão); tabela afinável por tamanho
+    void set_lmr(bool enabled) { use_lmr = enabled; }
+    void set_lmr_params(int rows, int cols, const LMRParams& p);
+    // Extensões seletivas (desligadas por omissão): +1 ply quando quem joga tem
+    // uma só jogada ou o marcador está a <= 2 passos de um dos objetivos;
+    // 'budget' extensões por iteração da raiz, no máximo kMaxPathExtension por linha
+    static constexpr int kDefaultExtensionBudget = 256;
+    static constexpr int kMaxPathExtension = 4;
+    void set_extensions(bool enabled, int budget = kDefaultExtensionBudget) {
+        use_extensions = enabled; extension_budget = std::max(0, budget);
+    }
+    // Paragem cooperativa: pode ser pedida de outra thread durante choose_move.
+    // A procura interrompida não grava na TT e o resultado deve ser descartado.
+    void request_stop() { stop.requested.store(true, std::memory_order_relaxed); }
+    void clear_stop() { stop.requested.store(false, std::memory_order_relaxed); }
+    bool search_aborted() const { return aborted; }
+    // Orçamento de nós (0 = desligado): choose_move aprofunda iterativamente até
+    // 'nodes' nós de minimax/quiescence e devolve a melhor jogada da última
+    // iteração completa. Com set_seed, o resultado não depende da máquina.
+    void set_node_budget(uint64_t nodes) { node_budget = nodes; }
+    int last_completed_depth() const { return completed_depth; }
+    uint64_t last_search_nodes() const { return budget_nodes; }
+    // Multi-PV: as k melhores jogadas da raiz (melhor primeiro) com score exato e PV
+    std::vector<RootLine> analyse(const Board& board, int k, const AnalysisLimits& limits = AnalysisLimits{});
+    // Limite de tempo por jogada em ms (0 = desligado): como set_node_budget,
+    // devolve a melhor jogada da última iteração completa dentro do prazo
+    void set_move_time(int ms) { move_time_ms = std::max(0, ms); }
+    // Orçamento do relógio (TimeManager): 'hard_ms' corta a procura como
+    // set_move_time; entre iterações pára ao passar 'soft_ms', esticado x2 se a
+    // melhor jogada acabou de mudar e encolhido a metade se está estável (0 = desligado)
+    void set_time_budget(int soft_ms, int hard_ms) {
+        soft_time_ms = std::max(0, soft_ms);
+        hard_time_ms = std::max(0, hard_ms);
+    }
+    // Chamado no fim de cada iteração completa de choose_move (ativa o aprofundamento iterativo)
+    void set_progress_callback(std::function<void(const SearchProgress&)> cb) { progress_cb = std::move(cb); }
+    // Procura assíncrona (thread própria; síncrona no WASM sem pthreads) com os
+    // mesmos atalhos de choose_move. A AI não pode ser usada até wait()/destruição
+    // do handle; 'on_progress' corre na thread da procura.
+    class SearchHandle start_search(const Board& board, const SearchLimits& limits,
+                                    std::function<void(const SearchProgress&)> on_progress = {});
+    // Semente fixa para a 1ª jogada aleatória e as políticas de ordenação com ruído
+    void set_seed(uint64_t seed);
     // Estatísticas (expostas para ferramentas de teste/benchmark)
     void print_ordering_stats() const;
+    const OrderingStats& ordering_stats(bool is_max_node) const { return stats_for(is_max_node); }
     void reset_ordering_stats();
     void clear_tt();                                     // limpa tTT
     void clear_order_caches();                           // limpa caches de ordenação
@@ -205,12 +428,14 @@ public:
     // Factories e utilitários estáticos
     static std::unique_ptr<AI> create_with_level(bool is_max, int depth, int level, int debug = 0);
     static void register_heuristics();
-    static int rounds();
+    int rounds() const { return ctx->rounds; }
 
-    // contadores globais de TT usados em testes/diagnóstico
-    static uint64_t vs_lookups;   
-    static uint64_t vs_hits;      
-    static uint64_t vs_inserts;  
+    // Estado de procura desta AI (caches + contadores da TT para testes/diagnóstico)
+    const SearchContext& search_context() const { return *ctx; }
+    void reset_search_counters() { ctx->reset_counters(); }
+    // Partilha explícita das caches/contadores com 'other' (mesma thread):
+    // p.ex. duas AIs com a mesma heurística a analisar a mesma partida
+    void share_search_context(const AI& other) { ctx.share(other.ctx); }
 
     // Wrappers para primitivas de heurística centralizadas em HeuristicsUtils
     // Tornados públicos para permitir uso em testes (ex.: test_ai.cpp)
@@ -219,7 +444,8 @@ public:
     static int h_distance(const Board& board, std::pair<int, int> pos, bool is_max) { return ::h_distance(board, pos, is_max); }
 
 private:
-    static int count_visited;
+    friend class ResumableSearch;   // mesma procura com pilha explícita (retomável)
+    SearchContextRef ctx;
 
     static std::map<int, std::function<int(const Board&, bool)>> heuristic_levels;
     bool is_max;
@@ -235,6 +461,8 @@ private:
     int minimax(Board& board, bool is_max, int depth, int alpha, int beta, int max_depth, int player_search);
     int minimax_noTT(Board board, bool is_max, int depth, int alpha, int beta, int max_depth, int player_search);
     int minimax_no_pruning(Board board, bool is_max, int depth, int max_depth, int player_search);
+    // Procura de janela nula do modo vitória/derrota: ±1000 provado, 0 = desconhecido a max_depth
+    int wl_search(Board& board, bool is_max, int depth, int alpha, int beta, int max_depth);
 
     int total_heuristic(const Board& board, bool is_max);
 
@@ -246,25 +474,88 @@ private:
     std::function<int(const Board&, bool)> heuristic;
     int default_heuristic(const Board& board, bool is_max);
 
-    static int s_rounds;
 
   
     // ordenação e cache de sucessores
-    const std::vector<MoveScore>& ordered_children(Board& board, bool is_max, int depth,
+    MoveList::Decoded ordered_children(Board& board, bool is_max, int depth,
                                          int max_depth, int player_search);
 
 
     // --- Quiescence search
-    bool use_quiescence = true;
+    // desligada por omissão; ativar via set_quiescence / configure_quiescence
+    bool use_quiescence = false;
     int  q_max_plies    = 4;   // profundidade limite (tune 2..6)
-    int  q_swing_delta  = 2;   // variação no caminho
+    int  q_swing_delta  = 2;   // raio (Chebyshev) em torno dos objetivos considerado tático
     int  q_low_mob      = 2;   // limite the mobilidade do adversário
 
-    int quiescence(Board board, bool is_max, int alpha, int beta, int qdepth, int base_depth);
-    std::vector<std::pair<int,int>> gen_quiescence_moves(const Board& board, bool is_max,
-                                                         int base_h1, int base_h5);
-    bool is_quiet_position(const Board& board, int base_h1, int base_h5);
+    // Sucessor de quiescence com features pré-calculadas (uma vez por nó)
+    struct QuiescenceChild {
+        std::pair<int,int> move;
+        bool wins;       // entra no objetivo de quem joga
+        int  reply_mob;  // jogadas disponíveis ao adversário após o lance
+        int  own_goal;   // Chebyshev até ao objetivo de quem joga
+    };
 
+    int quiescence(Board& board, bool is_max, int alpha, int beta, int qdepth, int base_depth,
+                   int player_search);
+    int gen_quiescence_moves(const Board& board, bool is_max,
+                             std::array<QuiescenceChild, 8>& out, int& legal, int& losing) const;
+    bool is_quiet_position(const Board& board) const;
+    int leaf_heuristic(const Board& board, bool is_max, int max_depth, int player_search);
+
+    std::unordered_map<CompactStateKey, TTEntry> qtt; // TT própria dos nós de quiescence
+
+
+    // --- Endgame de região isolada (objetivos inalcançáveis)
+    bool use_region_solver = true;
+    RegionSolver region_solver;
+    ProofNumberSolver pn_solver;
+    bool use_perfect_db = false;
+    bool use_opening_book = false;
+    bool use_corridor_macros = true;
+    bool use_goal_threats = true;
+    bool use_race_bounds = true;
+    bool use_etc = true;
+    static constexpr int kEtcMinRemaining = 2;   // profundidade restante mínima para ETC
+    bool use_iid = true;
+    int iid_min_remaining = 6;
+    int iid_reduction = 2;
+    static constexpr int kMaxCorridor = 32;
+
+    // --- Futilidade / razoring
+    bool use_futility = false;
+    FutilityParams futility;
+    bool razor_check = false;   // a próxima chamada a minimax é a confirmação do razoring
+    static bool has_stalemating_move(const Board& board);   // alguma jogada deixa o adversário sem saída
+
+    // --- Extensões seletivas
+    bool use_extensions = false;
+    int extension_budget = kDefaultExtensionBudget;
+    int extensions_left = 0;     // restantes na iteração em curso
+    int extension_root = 0;      // profundidade nominal da iteração (max_depth sem extensões)
+    void begin_extension_iteration(int root_depth) {
+        extensions_left = extension_budget;
+        extension_root = root_depth;
+    }
+    // Extensões ainda permitidas a um nó com este max_depth (orçamento e teto por linha)
+    int extension_room(int max_depth) const {
+        if (!use_extensions || extensions_left <= 0) return 0;
+        return std::min(extensions_left, kMaxPathExtension - (max_depth - extension_root));
+    }
+    static bool goal_race_near(const Board& board);   // marcador a <= 2 passos de um objetivo
+
+    // --- Late Move Reductions
+    bool use_lmr = false;
+    std::map<std::pair<int,int>, LMRParams> lmr_overrides;
+    struct LMRTable {
+        int rows = 0, cols = 0;    // tamanho para que foi construída (0 = inválida)
+        LMRParams params;
+        std::array<std::array<uint8_t, 8>, 64> r{};   // [restantes][índice do filho]
+    } lmr_table;
+    int lmr_reduction(const Board& board, int remaining, int child_idx);
+    static bool single_move(const Board& board, Board::Move& out);  // única jogada legal, se existir
+    // profundidade "infinita" para entradas exatas independentes do horizonte
+    static constexpr int kExactDepth = 1 << 20;
 
     OrderingPolicy ordering_policy = OrderingPolicy::Deterministic;
     double         order_noise_sigma = 0.75; // valor por defeito
@@ -274,6 +565,8 @@ private:
     CompactStateKey compact_state_key(const Board& board, bool is_max, int player_search) const;
 
      std::unordered_map<CompactStateKey, TTEntry> tt;
+     std::unordered_map<CompactStateKey, TTEntry> wl_tt;   // TT do modo vitória/derrota (valores ±1000/0)
+    uint64_t wl_nodes = 0, wl_budget = 0;
 
     // estatisticas para MAx e MIN
     OrderingStats ord_max_;
@@ -288,7 +581,68 @@ private:
     }
 
     int last_max_depth_reached = 0;
+    SearchStop stop;
+    bool aborted = false;   // a última procura foi interrompida por request_stop
+    uint64_t node_budget = 0;
+    int move_time_ms = 0;
+    int soft_time_ms = 0;
+    int hard_time_ms = 0;
+    bool use_deadline = false;
+    bool deadline_hit = false;
+    std::chrono::steady_clock::time_point deadline;
+    std::function<void(const SearchProgress&)> progress_cb;
+    // paragem pedida, nós esgotados ou prazo ultrapassado (relógio lido a cada 1024 nós)
+    bool search_limit_hit() {
+        if (stop.requested.load(std::memory_order_relaxed)) return true;
+        if (node_budget && budget_nodes >= node_budget) return true;
+        if (use_deadline && !deadline_hit && (budget_nodes & 1023) == 0)
+            deadline_hit = std::chrono::steady_clock::now() >= deadline;
+        return deadline_hit;
+    }
+    uint64_t budget_nodes = 0;     // nós de minimax/quiescence da última choose_move
+    int completed_depth = 0;       // profundidade da última iteração completa
+    bool seeded = false;
+    std::mt19937 seeded_rng;
+    std::mt19937& rng();
+    int last_best_score = 0;
+
+    // Tabela triangular da PV (só preenchida durante analyse)
+    static constexpr int kMaxPly = 64;
+    bool track_pv = false;
+    std::vector<std::pair<int,int>> pv_table;   // [ply * kMaxPly + i]
+    std::vector<int> pv_len;
+    void pv_splice(int ply, const std::pair<int,int>* moves, int n);
 
 };
 
+// Procura em curso lançada por AI::start_search. stop() pede a paragem (o
+// resultado fica com a última iteração completa); o destrutor pára e espera.
+class SearchHandle {
+public:
+    SearchHandle() = default;
+    SearchHandle(SearchHandle&& o) noexcept;
+    SearchHandle& operator=(SearchHandle&& o);
+    SearchHandle(const SearchHandle&) = delete;
+    SearchHandle& operator=(const SearchHandle&) = delete;
+    ~SearchHandle();
+
+    void stop();
+    SearchResult wait();
+    std::shared_future<SearchResult> future() const { return result; }
+    bool ready() const;
+    // Último progresso recebido (para quem faz polling, p.ex. a UI no WASM)
+    SearchProgress last_progress() const;
+
+private:
+    friend class AI;
+    struct Shared {
+        mutable std::mutex mtx;
+        SearchProgress progress;
+    };
+    AI* ai = nullptr;
+    std::thread worker;
+    std::shared_future<SearchResult> result;
+    std::shared_ptr<Shared> shared;
+};
+
 #endif // AI_HPP
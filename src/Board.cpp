@@ -17,10 +17,12 @@
 // ----------------------------------------------------------------------------
 
 #include "Board.hpp"
+#include "SearchArena.hpp"
 #include <iostream>
-#include <queue>
+#include <memory_resource>
 #include <limits>
 #include <random>
+#include <algorithm>
 
 // Construtor com dimensões: cria tabuleiro rows x cols com marcador na posição padrão.
 Board::Board(int r, int c) : rows(r), cols(c) {
@@ -56,15 +58,19 @@ Board::Board(int r, int c, bool skip_initial_marker) : rows(r), cols(c) {
 
 std::vector<std::pair<int, int>> Board::get_valid_moves() const {
     // Retorna todas as jogadas válidas a partir da posição atual do marcador.
-    std::vector<std::pair<int, int>> moves;
+    const auto list = valid_move_list().decode(marker);
+    return std::vector<std::pair<int, int>>(list.begin(), list.end());
+}
+
+MoveList Board::valid_move_list() const {
+    MoveList moves;
     int r = marker.first, c = marker.second;
-    // 8 direções (ortogonais + diagonais)
-    int dirs[8][2] = {{-1,0},{1,0},{0,-1},{0,1},{-1,-1},{-1,1},{1,-1},{1,1}};
-    for (auto& d : dirs) {
-        int nr = r + d[0], nc = c + d[1];
+    // 8 direções (ortogonais + diagonais), pela ordem de PackedMove::kDr/kDc
+    for (uint8_t d = 0; d < 8; ++d) {
+        int nr = r + PackedMove::kDr[d], nc = c + PackedMove::kDc[d];
         // Dentro dos limites e casa livre?
         if (nr >= 0 && nr < rows && nc >= 0 && nc < cols && grid[nr][nc] == 1) {
-            moves.emplace_back(nr, nc);
+            moves.push_back(PackedMove{d});
         }
     }
     return moves;
@@ -88,7 +94,7 @@ bool Board::is_terminal() const {
     // 1) não existirem jogadas válidas (o jogador da vez fica "bloqueado"), ou
     // 2) o marcador atingir o objetivo de J1 (rows-1, 0), ou
     // 3) o marcador atingir o objetivo de J2 (0, cols-1).
-    return get_valid_moves().empty() ||
+    return valid_move_list().empty() ||
            marker == std::make_pair(rows-1, 0) ||
            marker == std::make_pair(0,cols-1);
 }
@@ -136,13 +142,16 @@ Board::ReachabilityResult Board::compute_distance() const {
     // • h1 é devolvido como valor NEGATIVO (para facilitar perspetiva de MAX).
     // • h5 é devolvido como valor POSITIVO (para facilitar perspetiva de MIN).
 
-    // Matriz de células visitadas
-    std::vector<std::vector<bool>> visited(rows, std::vector<bool>(cols, false));
+    // Scratch na arena da procura em curso (SearchArena), libertado à saída
+    SearchArena::Frame frame;
+    std::pmr::memory_resource* mr = SearchArena::current();
 
-    // Fila para BFS: cada elemento contém (posição, distância)
-    std::queue<std::pair<std::pair<int, int>, int>> q;
-    q.push({marker, 0});
-    visited[marker.first][marker.second] = true;
+    // Células visitadas (flat) e fila da BFS: cada elemento contém (célula, distância)
+    std::pmr::vector<uint8_t> visited(static_cast<size_t>(rows) * cols, 0, mr);
+    std::pmr::vector<std::pair<int, int>> q(mr);
+    q.reserve(static_cast<size_t>(rows) * cols);
+    q.push_back({marker.first * cols + marker.second, 0});
+    visited[marker.first * cols + marker.second] = 1;
 
     //objetivos
     int goal_r_max = rows - 1, goal_c_max = 0;
@@ -151,17 +160,10 @@ Board::ReachabilityResult Board::compute_distance() const {
     int h1 = 900, h5 = 900;
     int count = 0;
 
-    // Direções de movimento (8 vizinhos: ortogonais + diagonais)
-    int dirs[8][2] = {
-        {-1, 0}, {1, 0}, {0, -1}, {0, 1},
-        {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
-    };
-
-
-    // BFS
-    while (!q.empty()) {
-        auto [pos, dist] = q.front(); q.pop();
-        int r = pos.first, c = pos.second;
+    // BFS (8 vizinhos: ortogonais + diagonais)
+    for (size_t head = 0; head < q.size(); ++head) {
+        const auto [cell, dist] = q[head];
+        int r = cell / cols, c = cell % cols;
         count++;
         // Se atingiu o objetivo de MAX, atualiza h1
         if (r == goal_r_max && c == goal_c_max) h1 = std::min(h1, dist);
@@ -169,12 +171,12 @@ Board::ReachabilityResult Board::compute_distance() const {
         if (r == goal_r_min && c == goal_c_min) h5 = std::min(h5, dist);
 
         // Explora vizinhos válidos
-        for (auto& d : dirs) {
-            int nr = r + d[0], nc = c + d[1];
+        for (int d = 0; d < 8; ++d) {
+            int nr = r + PackedMove::kDr[d], nc = c + PackedMove::kDc[d];
             if (nr >= 0 && nr < rows && nc >= 0 && nc < cols &&
-                grid[nr][nc] == 1 && !visited[nr][nc]) {
-                visited[nr][nc] = true;
-                q.push({{nr, nc}, dist + 1});
+                grid[nr][nc] == 1 && !visited[nr * cols + nc]) {
+                visited[nr * cols + nc] = 1;
+                q.push_back({nr * cols + nc, dist + 1});
             }
         }
     }
@@ -187,6 +189,59 @@ Board::ReachabilityResult Board::compute_distance() const {
 }
 
 
+int Board::free_neighbours(int r, int c) const {
+    int count = 0;
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            if (dr == 0 && dc == 0) continue;
+            int nr = r + dr, nc = c + dc;
+            if (nr >= 0 && nr < rows && nc >= 0 && nc < cols && grid[nr][nc] == 1) count++;
+        }
+    }
+    return count;
+}
+
+int Board::forced_line_after(const Move& mv, int max_len) const {
+    static constexpr int kMaxLine = 32;
+    max_len = std::min(max_len, kMaxLine);
+
+    auto is_goal = [&](const Move& p) {
+        return p == std::make_pair(rows - 1, 0) || p == std::make_pair(0, cols - 1);
+    };
+    if (is_goal(mv)) return -1;
+
+    // Casas que ficam bloqueadas ao longo da linha (marcador atual + percorridas);
+    // com diagonais, uma casa pode tocar em qualquer anterior, não só na última.
+    Move path[kMaxLine + 2];
+    int n = 0;
+    path[n++] = marker;
+    Move cur = mv;
+
+    for (int plies = 0; plies <= max_len; ++plies) {
+        int cnt = 0;
+        Move next{-1, -1};
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                if (dr == 0 && dc == 0) continue;
+                int nr = cur.first + dr, nc = cur.second + dc;
+                if (nr < 0 || nr >= rows || nc < 0 || nc >= cols || grid[nr][nc] != 1) continue;
+                bool blocked = false;
+                for (int i = 0; i < n; ++i) {
+                    if (path[i].first == nr && path[i].second == nc) { blocked = true; break; }
+                }
+                if (blocked) continue;
+                if (++cnt > 1) return -1;   // linha abre: há escolha
+                next = {nr, nc};
+            }
+        }
+        if (cnt == 0) return plies;         // quem está em 'cur' fica bloqueado
+        if (is_goal(next)) return -1;
+        path[n++] = cur;
+        cur = next;
+    }
+    return -1;
+}
+
 
 // ============================================================================
 // HELPERS (WASM/UI) PARA REINICIALIZAÇÃO E EDIÇÃO DE ESTADO
@@ -314,6 +369,17 @@ Board::MoveUndo Board::apply_move(const Move& mv) {
     return u;
 }
 
+uint64_t Board::hash_after(const Move& mv) const {
+    // mesmas operações de make_move: bloqueia a casa atual e move o marcador
+    uint64_t h = hash_value;
+    const int old_state = grid[marker.first][marker.second] ? 1 : 0;
+    h ^= zobrist_table[marker.first][marker.second][old_state];
+    h ^= zobrist_table[marker.first][marker.second][0];
+    h ^= hash_marker_component();
+    h ^= ((static_cast<uint64_t>(mv.first) << 32) ^ static_cast<uint64_t>(mv.second)) ^ zobrist_marker_magic;
+    return h;
+}
+
 void Board::undo_move(const MoveUndo& u) {
     // Restaurar jogador e marcador
     current_player = u.old_current_player;
@@ -19,6 +19,7 @@
 #include <utility>
 #include <array>
 #include <cstdint>
+#include "Move.hpp"
 
 /** 
  * @class Board
@@ -49,6 +50,9 @@ public:
     MoveUndo apply_move(const Move& mv);
     void undo_move(const MoveUndo& u);
 
+    // Hash da posição após 'mv' (atualização incremental, sem aplicar a jogada)
+    uint64_t hash_after(const Move& mv) const;
+
     /** 
      * Construtor com dimensões explícitas.
      * @param rows Número de linhas.
@@ -73,6 +77,9 @@ public:
      * @return Vetor de pares (r,c) alcançáveis numa jogada.
      */
     std::vector<std::pair<int, int>> get_valid_moves() const;
+    // Mesmas jogadas e ordem, compactas (3 bits por direção, sem alocação);
+    // usada dentro do motor, get_valid_moves fica para a API
+    MoveList valid_move_list() const;
 
     void make_move(std::pair<int, int> move);
     bool is_terminal() const;
@@ -97,6 +104,28 @@ public:
 
     ReachabilityResult compute_distance() const;
 
+    // Nº de vizinhos livres (8 direções) da célula (r,c). Barato (sem BFS),
+    // usado pela quiescence para medir mobilidade de resposta.
+    int free_neighbours(int r, int c) const;
+
+    // Segue a linha forçada após 'mv' sem alterar o tabuleiro: enquanto quem
+    // joga tiver exatamente uma jogada. Devolve o nº de jogadas forçadas até
+    // alguém ficar bloqueado (0 = o adversário fica sem jogadas logo após 'mv';
+    // par -> vitória de quem joga 'mv', ímpar -> derrota), ou -1 se a linha
+    // abrir (≥2 escolhas), passar por um objetivo ou exceder max_len.
+    int forced_line_after(const Move& mv, int max_len = 16) const;
+
+    // Ameaça de objetivo: a partir de (r,c) entra-se no objetivo de MAX
+    // (max_goal=true) ou de MIN na jogada seguinte (casa vizinha do canto e
+    // objetivo ainda livre). Teste O(1) sobre a vizinhança do canto.
+    bool threatens_goal(int r, int c, bool max_goal) const {
+        const int gr = max_goal ? rows - 1 : 0;
+        const int gc = max_goal ? 0 : cols - 1;
+        if (grid[gr][gc] != 1) return false;
+        const int dr = r - gr, dc = c - gc;
+        return dr >= -1 && dr <= 1 && dc >= -1 && dc <= 1 && (dr | dc) != 0;
+    }
+
 
     // Helpers para lidar com posições a partir do JS
     // ------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+// ============================================================================
+// Calibration.cpp — Benchmark curto, cache em disco e profundidade derivada
+// ============================================================================
+
+#include "Calibration.hpp"
+#include "AI.hpp"
+#include "Board.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+Calibration::DepthLimits Calibration::depth_for(int target_ms) const {
+    DepthLimits out;
+    if (!valid() || target_ms <= 0) return out;
+    const double budget = nps * target_ms / 1000.0;
+    int d = budget > 1.0 ? static_cast<int>(std::log(budget) / std::log(ebf)) : 1;
+    d = std::clamp(d, 1, kMaxDepth);
+    if (d % 2 == 0) --d;   // profundidades ímpares, como no calendário
+    out.max_depth = std::max(1, d);
+    out.start_depth = std::max(1, out.max_depth - 4);
+    return out;
+}
+
+int Calibration::time_for_depth(int depth) const {
+    if (!valid()) return 0;
+    return static_cast<int>(std::ceil(std::pow(ebf, depth) / nps * 1000.0));
+}
+
+Calibration Calibration::measure(int rows, int cols, int bench_ms) {
+    Calibration c;
+    c.rows = rows;
+    c.cols = cols;
+    Board board(rows, cols);
+    AI ai(board.current_player_is_max(), kMaxDepth);
+    ai.set_opening_book(false);
+    ai.set_perfect_db(false);
+    ai.set_seed(1);
+    ai.set_move_time(std::max(1, bench_ms));
+
+    std::vector<uint64_t> totals;   // nós acumulados no fim de cada iteração
+    ai.set_progress_callback([&](const SearchProgress& p) { totals.push_back(p.nodes); });
+    const auto t0 = std::chrono::steady_clock::now();
+    ai.choose_move(board, kMaxDepth, /*rounds=*/3);
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    c.nps = secs > 0 ? ai.last_search_nodes() / secs : 0.0;
+    // razão entre os nós de iterações sucessivas (as duas últimas completas)
+    double ratio_sum = 0.0;
+    int ratios = 0;
+    for (size_t i = totals.size() >= 3 ? totals.size() - 2 : 1; i < totals.size(); ++i) {
+        const double prev = static_cast<double>(totals[i - 1] - (i >= 2 ? totals[i - 2] : 0));
+        const double cur = static_cast<double>(totals[i] - totals[i - 1]);
+        if (prev > 0 && cur > 0) { ratio_sum += cur / prev; ++ratios; }
+    }
+    c.ebf = std::clamp(ratios ? ratio_sum / ratios : 4.0, 1.5, 8.0);
+    return c;
+}
+
+std::string Calibration::default_path() {
+    const char* dir = std::getenv("RASTROS_DATA_DIR");
+    std::string base = (dir && *dir) ? dir : "data";
+    return base + "/calibration.txt";
+}
+
+Calibration Calibration::for_size(int rows, int cols) {
+    static std::mutex mtx;
+    static std::map<std::pair<int, int>, Calibration> known;
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = known.find({rows, cols});
+    if (it != known.end()) return it->second;
+
+    const std::string path = default_path();
+    {
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream ss(line);
+            Calibration c;
+            if (ss >> c.rows >> c.cols >> c.nps >> c.ebf && c.valid())
+                known[{c.rows, c.cols}] = c;
+        }
+    }
+    it = known.find({rows, cols});
+    if (it != known.end()) return it->second;
+
+    const Calibration c = measure(rows, cols);
+    known[{rows, cols}] = c;
+    std::ofstream out(path, std::ios::app);   // sem diretório: fica só em memória
+    if (out) out << c.rows << " " << c.cols << " " << c.nps << " " << c.ebf << "\n";
+    return c;
+}
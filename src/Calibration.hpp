@@ -0,0 +1,44 @@
+// ============================================================================
+// Calibration.hpp — Profundidade calibrada pela velocidade desta máquina
+// ----------------------------------------------------------------------------
+// O mesmo binário corre em servidores, portáteis e no cliente WASM; a
+// profundidade fixa (2/2 no GameController, 9/15 no TestController) fica
+// lenta demais nuns e fraca demais noutros.
+//
+// - measure(): procura curta e determinista (semente fixa, sem livro) no
+//   tabuleiro vazio durante bench_ms; dá os nós/s e o fator de ramificação
+//   efetivo (razão entre os nós de iterações sucessivas).
+// - for_size(): resultado por tamanho de tabuleiro, em memória e em
+//   $RASTROS_DATA_DIR/calibration.txt (uma linha "rows cols nps ebf"); só
+//   mede quando o tamanho ainda não está no ficheiro.
+// - depth_for(target_ms): maior profundidade ímpar cujos nós estimados
+//   (ebf^d) cabem em target_ms a esta velocidade; start = max - 4.
+// ============================================================================
+
+#pragma once
+#include <string>
+
+struct Calibration {
+    struct DepthLimits {
+        int start_depth = 1;
+        int max_depth = 1;
+    };
+
+    static constexpr int kBenchMs = 300;
+    static constexpr int kMaxDepth = 25;
+
+    int rows = 0;
+    int cols = 0;
+    double nps = 0.0;   // nós de minimax/quiescence por segundo
+    double ebf = 0.0;   // fator de ramificação efetivo
+
+    bool valid() const { return nps > 0.0 && ebf > 1.0; }
+
+    DepthLimits depth_for(int target_ms) const;
+    // Tempo estimado (ms) para completar uma procura à profundidade 'depth'
+    int time_for_depth(int depth) const;
+
+    static Calibration measure(int rows, int cols, int bench_ms = kBenchMs);
+    static Calibration for_size(int rows, int cols);
+    static std::string default_path();
+};
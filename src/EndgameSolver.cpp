@@ -0,0 +1,162 @@
+// ============================================================================
+// EndgameSolver.cpp — Implementação do solver exato de regiões isoladas
+// ----------------------------------------------------------------------------
+// - Células indexadas por r*cols + c (até 128 células -> 2 palavras de 64 bits).
+// - Estado = (células livres da região, posição do marcador); a célula do
+//   marcador nunca está na máscara (fica bloqueada ao sair).
+// - Quem joga sem vizinhos livres perde; ganha se existir um lance para um
+//   estado perdedor do adversário.
+// - Lances ordenados pela mobilidade que deixam ao adversário (menor primeiro):
+//   entrar num beco sem saída é vitória imediata.
+// ============================================================================
+
+#include "EndgameSolver.hpp"
+#include <algorithm>
+#include <bitset>
+
+namespace {
+    inline int popcount64(uint64_t x) {
+    #if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(x);
+    #else
+        return static_cast<int>(std::bitset<64>(x).count());
+    #endif
+    }
+
+    inline int ctz64(uint64_t x) {
+    #if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(x);
+    #else
+        int n = 0;
+        while (!(x & 1ULL)) { x >>= 1; ++n; }
+        return n;
+    #endif
+    }
+}
+
+RegionSolver::RegionSolver(int max_cells, uint64_t node_budget, std::size_t max_entries)
+    : max_cells(max_cells), solvable_cells(max_cells), node_budget(node_budget),
+      max_entries(max_entries) {}
+
+void RegionSolver::clear() {
+    memo.clear();
+    nodes = 0;
+    solvable_cells = max_cells;
+}
+
+void RegionSolver::prepare(int r, int c) {
+    if (r == rows && c == cols && !adj.empty()) return;
+    rows = r;
+    cols = c;
+    memo.clear();
+    adj.assign(static_cast<std::size_t>(rows * cols), Mask{});
+    for (int rr = 0; rr < rows; ++rr) {
+        for (int cc = 0; cc < cols; ++cc) {
+            Mask& m = adj[rr * cols + cc];
+            for (int dr = -1; dr <= 1; ++dr) {
+                for (int dc = -1; dc <= 1; ++dc) {
+                    if (dr == 0 && dc == 0) continue;
+                    int nr = rr + dr, nc = cc + dc;
+                    if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
+                    int idx = nr * cols + nc;
+                    if (idx < 64) m.lo |= (1ULL << idx);
+                    else          m.hi |= (1ULL << (idx - 64));
+                }
+            }
+        }
+    }
+}
+
+RegionSolver::Outcome RegionSolver::solve(const Board& board) {
+    const int R = board.get_rows(), C = board.get_cols();
+    nodes = 0;
+    if (R * C > 128) return Outcome::Unknown;
+    prepare(R, C);
+
+    // Região do marcador (flood fill sobre células livres, sem o marcador)
+    const auto& g = board.grid_ref();
+    const auto mk = board.get_marker();
+    const int start = mk.first * C + mk.second;
+    const int goal_max = (R - 1) * C;
+    const int goal_min = C - 1;
+
+    Mask region;
+    int stack[128];
+    int top = 0, count = 0;
+    stack[top++] = start;
+    while (top > 0) {
+        int cur = stack[--top];
+        int r = cur / C, c = cur % C;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                int nr = r + dr, nc = c + dc;
+                if (nr < 0 || nr >= R || nc < 0 || nc >= C || g[nr][nc] != 1) continue;
+                int idx = nr * C + nc;
+                bool seen = idx < 64 ? (region.lo >> idx) & 1ULL : (region.hi >> (idx - 64)) & 1ULL;
+                if (seen || idx == start) continue;
+                // objetivo alcançável: fora do âmbito do solver
+                if (idx == goal_max || idx == goal_min) return Outcome::Unknown;
+                if (++count > solvable_cells) return Outcome::Unknown;
+                if (idx < 64) region.lo |= (1ULL << idx);
+                else          region.hi |= (1ULL << (idx - 64));
+                stack[top++] = idx;
+            }
+        }
+    }
+
+    int res = dfs(region, start);
+    if (res < 0) {
+        solvable_cells = std::min(solvable_cells, count - 1);   // não voltar a regiões deste tamanho
+        return Outcome::Unknown;
+    }
+    return res ? Outcome::Win : Outcome::Loss;
+}
+
+int RegionSolver::dfs(const Mask& free, int pos) {
+    if (++nodes > node_budget) return -1;
+
+    const Mask moves{adj[pos].lo & free.lo, adj[pos].hi & free.hi};
+    if (!moves.lo && !moves.hi) return 0; // sem jogadas: quem joga perde
+
+    Key key{free, pos};
+    if (auto it = memo.find(key); it != memo.end()) return it->second ? 1 : 0;
+
+    // Candidatos com a mobilidade que deixam ao adversário
+    int cand[8], mob[8];
+    int n = 0;
+    for (int w = 0; w < 2; ++w) {
+        uint64_t bits = w == 0 ? moves.lo : moves.hi;
+        while (bits) {
+            int b = ctz64(bits);
+            bits &= bits - 1;
+            int idx = b + 64 * w;
+            Mask nf = free;
+            if (w == 0) nf.lo &= ~(1ULL << b);
+            else        nf.hi &= ~(1ULL << b);
+            cand[n] = idx;
+            mob[n] = popcount64(adj[idx].lo & nf.lo) + popcount64(adj[idx].hi & nf.hi);
+            ++n;
+        }
+    }
+    for (int i = 1; i < n; ++i) {
+        int ci = cand[i], mi = mob[i], j = i - 1;
+        while (j >= 0 && mob[j] > mi) { cand[j + 1] = cand[j]; mob[j + 1] = mob[j]; --j; }
+        cand[j + 1] = ci;
+        mob[j + 1] = mi;
+    }
+
+    bool win = false;
+    for (int i = 0; i < n && !win; ++i) {
+        if (mob[i] == 0) { win = true; break; } // adversário fica bloqueado
+        Mask nf = free;
+        if (cand[i] < 64) nf.lo &= ~(1ULL << cand[i]);
+        else              nf.hi &= ~(1ULL << (cand[i] - 64));
+        int r = dfs(nf, cand[i]);
+        if (r < 0) return -1;
+        if (r == 0) win = true;
+    }
+
+    if (memo.size() >= max_entries) memo.clear();
+    memo.emplace(key, win);
+    return win ? 1 : 0;
+}
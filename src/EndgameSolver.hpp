@@ -0,0 +1,74 @@
+// ============================================================================
+// EndgameSolver.hpp — Solver exato para regiões isoladas
+// ----------------------------------------------------------------------------
+// Quando nenhum dos objetivos é alcançável a partir do marcador (compute_distance
+// devolve h1 = -900 e h5 = 900) o jogo reduz-se a "quem fica primeiro sem
+// jogadas" dentro da região do marcador. Este solver resolve essa subpartida
+// de forma exata com DFS + memo próprio, chaveado pelas células livres
+// (máscara absoluta de 128 bits) e pela posição do marcador.
+//
+// Uma região que esgota o orçamento de nós baixa o teto de células aceites
+// (cell_limit): as regiões dos nós abaixo dela, quase do mesmo tamanho,
+// deixam de repetir o DFS inteiro em cada nó do minimax. O teto só volta a
+// max_cells em clear() (nova partida).
+// ============================================================================
+
+#pragma once
+#include "Board.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+class RegionSolver {
+public:
+    // Resultado na perspetiva de quem joga
+    enum class Outcome : uint8_t { Unknown, Win, Loss };
+
+    // max_cells: maior região aceite; node_budget: nós por chamada a solve();
+    // max_entries: limite do memo (limpo ao ser atingido)
+    explicit RegionSolver(int max_cells = 64, uint64_t node_budget = 20000,
+                          std::size_t max_entries = (1u << 18));
+
+    // Resolve a posição atual. Pré-condição: objetivos inalcançáveis.
+    // Devolve Unknown se a região exceder cell_limit(), o tabuleiro tiver mais
+    // de 128 células, ou o orçamento de nós se esgotar.
+    Outcome solve(const Board& board);
+
+    void clear();
+    uint64_t last_nodes() const { return nodes; }
+    int cell_limit() const { return solvable_cells; }
+
+private:
+    struct Mask {
+        uint64_t lo = 0, hi = 0;
+        bool operator==(const Mask& o) const { return lo == o.lo && hi == o.hi; }
+    };
+    struct Key {
+        Mask free;
+        int pos = 0;
+        bool operator==(const Key& o) const { return free == o.free && pos == o.pos; }
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const {
+            uint64_t h = k.free.lo * 0x9e3779b97f4a7c15ULL;
+            h ^= (k.free.hi + 0x7f4a7c159e3779b9ULL + (h << 6) + (h >> 2));
+            h ^= (static_cast<uint64_t>(k.pos) + 0x9e3779b9 + (h << 6) + (h >> 2));
+            return static_cast<std::size_t>(h);
+        }
+    };
+
+    // -1 = orçamento esgotado; 0 = quem joga perde; 1 = quem joga ganha
+    int dfs(const Mask& free, int pos);
+    void prepare(int rows, int cols);
+
+    int max_cells;
+    int solvable_cells;     // teto atual (< tamanho da menor região que esgotou o orçamento)
+    uint64_t node_budget;
+    std::size_t max_entries;
+
+    int rows = 0, cols = 0;
+    std::vector<Mask> adj;  // vizinhos (8 direções) de cada célula
+    std::unordered_map<Key, bool, KeyHash> memo;
+    uint64_t nodes = 0;
+};
@@ -1,6 +1,7 @@
 #include "GameController.hpp"
 #include <iostream>
 #include <random>
+#include <chrono>
 
 
 GameController::GameController(const std::string& mode, int rows, int cols)
@@ -18,6 +19,7 @@ GameController::GameController(const std::string& mode, int rows, int cols)
         ai_player = AI(true, max_depth);
         ai_player_2 = AI(false, max_depth);
     }
+    use_precomputed_tables();
 }
 
 
@@ -36,10 +38,24 @@ GameController::GameController(const std::string& mode, int rows, int cols, cons
         ai_player = AI(true, max_depth);
         ai_player_2 = AI(false, max_depth);
     }
+    use_precomputed_tables();
 }
 
 
 
+// Jogo interativo: tabelas pré-calculadas (data/), se existirem, para as duas IAs
+void GameController::use_precomputed_tables() {
+    for (AI* ai : {&ai_player, &ai_player_2}) {
+        ai->set_perfect_db(true);
+        ai->set_opening_book(true);
+    }
+}
+
+GameController::~GameController() {
+    finish_pondering({-1, -1});
+}
+
+
 void GameController::run() {
     while (!board.is_terminal()) {
         print_board();
@@ -70,11 +86,140 @@ void GameController::play_ai_turn() {
     std::pair<int, int> move;
 
     auto& ai = board.current_player_is_max() ? ai_player : ai_player_2;
-    int depth = std::min(start_depth + rounds / 5, max_depth);
-    depth = (depth % 2 == 0) ? depth - 1 : depth;
-    depth = std::max(depth, start_depth);
-    move = ai.choose_move(board,depth,rounds);
+    int depth = ai_depth(rounds);
+    if (ponder_move.first >= 0 && depth == ponder_depth) {
+        move = ponder_move;   // procurada durante o turno do humano
+        std::cout << "⚡ Jogada calculada durante o turno do adversário (ponder hit)\n";
+        auto& clock = board.current_player_is_max() ? clock_p1 : clock_p2;
+        if (clock.enabled()) {
+            clock.consume(ponder_wait_ms);   // só a espera pela resposta em curso
+            std::cout << "⏱ relógio: " << clock.remaining_ms() << " ms\n";
+        }
+    } else {
+        move = search_move(ai, depth);
+    }
+    ponder_move = {-1, -1};
     board.make_move(move);
+    start_pondering(ai);
+}
+
+// Procura da jogada (start_search + wait): limite de tempo e progresso opcionais
+std::pair<int, int> GameController::search_move(AI& ai, int depth) {
+    std::function<void(const SearchProgress&)> on_progress;
+    if (show_progress) {
+        on_progress = [](const SearchProgress& p) {
+            std::cout << "  d=" << p.depth << " score=" << p.score << " nodes=" << p.nodes
+                      << " nps=" << static_cast<uint64_t>(p.nps) << " pv";
+            for (const auto& mv : p.pv) std::cout << " (" << mv.first << "," << mv.second << ")";
+            std::cout << "\n";
+        };
+    }
+    auto& clock = board.current_player_is_max() ? clock_p1 : clock_p2;
+    if (!clock.enabled()) {
+        auto search = ai.start_search(board, SearchLimits{depth, 0, move_time_ms, rounds}, on_progress);
+        return search.wait().move;
+    }
+    const auto budget = clock.allocate(board);
+    const auto t0 = std::chrono::steady_clock::now();
+    ai.set_time_budget(budget.soft_ms, budget.hard_ms);
+    auto search = ai.start_search(board, SearchLimits{depth, 0, 0, rounds}, on_progress);
+    auto move = search.wait().move;
+    ai.set_time_budget(0, 0);
+    clock.consume(static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count()));
+    std::cout << "⏱ relógio: " << clock.remaining_ms() << " ms\n";
+    return move;
+}
+
+// Profundidade usada pela IA no turno 'at_round' (ímpar, entre start e max);
+// com relógio a IA aprofunda até max_depth dentro do orçamento
+int GameController::ai_depth(int at_round) const {
+    if (clock_p1.enabled() || clock_p2.enabled()) return max_depth;
+    return TimeManager::scheduled_depth(start_depth, max_depth, at_round);
+}
+
+// ----------------------------------------------------------------------------
+// Pondering:
+// - Após a jogada da IA (modos humano vs IA), uma thread procura cada resposta
+//   possível do humano com a mesma AI (e a mesma TT) e à profundidade do
+//   próximo turno, guardando resposta -> jogada.
+// - Quando o humano joga: se essa resposta já foi procurada, a jogada fica
+//   pronta (ponder hit); se está a ser procurada, deixa-se terminar; caso
+//   contrário a procura em curso é interrompida (request_stop) e a IA procura
+//   normalmente, aproveitando a TT preenchida pelas respostas anteriores.
+// - Com relógio (profundidade = max_depth) cada resposta leva o orçamento que
+//   a jogada seguinte da IA teria; a espera por uma resposta em curso é
+//   descontada no relógio da IA no ponder hit.
+// ----------------------------------------------------------------------------
+void GameController::start_pondering(AI& ai) {
+    if (!pondering_enabled || (mode != "ai_first" && mode != "human_first")) return;
+    finish_pondering({-1, -1});
+
+    Board pos = board;
+    pos.switch_player();   // humano a jogar
+    if (pos.is_terminal()) return;
+
+    const int next_round = rounds + 2;
+    ponder_ai = &ai;
+    ponder_depth = ai_depth(next_round);
+    ponder_results.clear();
+    ponder_current = {-1, -1};
+    ponder_stop = false;
+    ponder_done = false;
+    ai.clear_stop();
+
+    const int depth = ponder_depth;
+    const TimeManager clock = board.current_player_is_max() ? clock_p1 : clock_p2;
+    ponder_thread = std::thread([this, &ai, pos, next_round, depth, clock]() {
+        for (const auto& reply : pos.get_valid_moves()) {
+            if (ponder_stop.load()) break;
+            Board child = pos;
+            child.apply_move(reply);
+            if (child.is_terminal()) continue;
+            {
+                std::lock_guard<std::mutex> lock(ponder_mtx);
+                ponder_current = reply;
+            }
+            if (clock.enabled()) {
+                const auto budget = clock.allocate(child);
+                ai.set_time_budget(budget.soft_ms, budget.hard_ms);
+            }
+            auto mv = ai.choose_move(child, depth, next_round);
+            ai.set_time_budget(0, 0);
+            std::lock_guard<std::mutex> lock(ponder_mtx);
+            ponder_current = {-1, -1};
+            if (!ai.search_aborted()) ponder_results[reply] = mv;
+        }
+        ponder_done = true;
+    });
+}
+
+// Resolve o pondering com a resposta real do humano ({-1,-1} = cancelar)
+void GameController::finish_pondering(const Board::Move& reply) {
+    if (!ponder_thread.joinable()) return;
+
+    bool in_progress = false;
+    {
+        std::lock_guard<std::mutex> lock(ponder_mtx);
+        in_progress = reply.first >= 0 && ponder_current == reply;
+    }
+    ponder_stop = true;                                // não começar outras respostas
+    if (!in_progress) ponder_ai->request_stop();       // resposta em curso é outra: interromper
+    const auto t0 = std::chrono::steady_clock::now();
+    ponder_thread.join();
+    ponder_wait_ms = in_progress ? static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count()) : 0;
+    ponder_ai->clear_stop();
+
+    ponder_move = {-1, -1};
+    auto it = ponder_results.find(reply);
+    if (it != ponder_results.end()) {
+        ponder_move = it->second;
+        ponder_hits++;
+    } else if (reply.first >= 0) {
+        ponder_misses++;
+    }
+    ponder_results.clear();
 }
 
 void GameController::play_human_turn() {
@@ -90,7 +235,9 @@ void GameController::play_human_turn() {
     int choice;
     std::cout << "Escolhe uma jogada: ";
     std::cin >> choice;
-    if (choice >= 0 && static_cast<size_t>(choice) < moves.size()) {
+    const bool valid = choice >= 0 && static_cast<size_t>(choice) < moves.size();
+    finish_pondering(valid ? moves[choice] : Board::Move{-1, -1});
+    if (valid) {
         board.make_move(moves[choice]);
     }
 }
@@ -99,10 +246,8 @@ void GameController::play_ai_vs_ai_turn() {
     std::cout << "\nTurno do ";
     std::cout << (board.current_player_is_max() ? "Jogador 1 (IA)" : "Jogador 2 (IA)") << "...\n";
     auto& ai = board.current_player_is_max() ? ai_player : ai_player_2;
-    int depth = std::min(start_depth + rounds / 5, max_depth);
-    depth = (depth % 2 == 0) ? depth - 1 : depth;
-    depth = std::max(depth, start_depth);
-    auto move = ai.choose_move(board, depth,rounds);
+    int depth = ai_depth(rounds);
+    auto move = search_move(ai, depth);
 
     board.make_move(move);
 }
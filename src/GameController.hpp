@@ -1,36 +1,93 @@
 #pragma once
 #include "Board.hpp"
 #include "AI.hpp"
+#include "TimeManager.hpp"
 #include <string>
+#include <algorithm>
 #include <vector>
 #include <utility>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
 
 class GameController {
 public:
     GameController(const std::string& mode, int rows, int cols);
     GameController(const std::string& mode, int rows, int cols, const Board& board,int rounds);
 
+    ~GameController();
+    GameController(const GameController&) = delete;
+    GameController& operator=(const GameController&) = delete;
+
     void run();
 
     int get_rows() const { return board.get_rows(); }
     int get_cols() const { return board.get_cols(); }
     int get_current_player() const { return board.current_player_is_max() ? 1 : 2; }
     bool is_game_over() const { return board.is_terminal(); }
-    void make_move(int row, int col) { board.make_move({row, col}); }
+    void make_move(int row, int col) { finish_pondering({row, col}); board.make_move({row, col}); }
     void run_ai_turn();
     std::pair<int, int> get_marker();
     std::vector<std::pair<int, int>> get_valid_moves();
 
+    // Pondering: depois da jogada da IA, procura numa thread as respostas do
+    // humano enquanto este pensa (ligado por omissão quando há threads).
+    void set_pondering(bool enabled) { pondering_enabled = enabled; }
+    int get_ponder_hits() const { return ponder_hits; }
+    int get_ponder_misses() const { return ponder_misses; }
+    // true quando a thread de pondering já procurou todas as respostas (ou não há)
+    bool pondering_done() const { return ponder_done.load(); }
+
+    // Tempo por jogada da IA em ms (0 = só profundidade) e progresso de cada
+    // iteração no terminal; a procura corre por AI::start_search
+    void set_move_time(int ms) { move_time_ms = ms; }
+    void set_show_progress(bool enabled) { show_progress = enabled; }
+    // Profundidade da IA (por omissão 2/2; main usa a calibração da máquina)
+    void set_depth_limits(int start, int max) { start_depth = start; max_depth = std::max(start, max); }
+    // Relógio por lado (tempo total + incremento); com relógio a profundidade
+    // vai até max_depth e o orçamento de cada jogada vem do TimeManager
+    void set_clock(const TimeControl& tc) { clock_p1 = TimeManager(tc); clock_p2 = TimeManager(tc); }
+
 
 private:
     int rounds = 0;
     int start_depth = 2;
     int max_depth = 2;
+    int move_time_ms = 0;
+    bool show_progress = false;
+    TimeManager clock_p1;
+    TimeManager clock_p2;
     Board board;
     AI ai_player;
     AI ai_player_2;
     std::string mode;
 
+    // --- Pondering
+    #if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    bool pondering_enabled = false;   // build WASM sem pthreads
+    #else
+    bool pondering_enabled = true;
+    #endif
+    std::thread ponder_thread;
+    std::mutex ponder_mtx;
+    std::atomic<bool> ponder_stop{false};      // não iniciar mais respostas
+    std::atomic<bool> ponder_done{true};       // thread terminou todas as respostas
+    AI* ponder_ai = nullptr;
+    Board::Move ponder_current{-1, -1};        // resposta em procura
+    std::map<Board::Move, Board::Move> ponder_results;   // resposta -> jogada da IA
+    Board::Move ponder_move{-1, -1};           // jogada pronta para o próximo turno
+    int ponder_depth = 0;                      // profundidade usada no pondering
+    int ponder_wait_ms = 0;                    // espera pela resposta em curso (ponder hit)
+    int ponder_hits = 0;
+    int ponder_misses = 0;
+
+    void use_precomputed_tables();
+    int ai_depth(int at_round) const;
+    std::pair<int, int> search_move(AI& ai, int depth);
+    void start_pondering(AI& ai);
+    void finish_pondering(const Board::Move& reply);
+
     void print_board() const;
     void play_ai_turn();
     void play_human_turn();
@@ -63,11 +63,11 @@ int heuristic_combo_score(const Board& board, bool is_max, HeuristicCombo combo)
 }
 
 int h_trap(const Board& board, bool is_max) {
-    return board.get_valid_moves().size() <= 2 ? (is_max ? -5 : 5) : 0;
+    return board.valid_move_list().size() <= 2 ? (is_max ? -5 : 5) : 0;
 }
 
 int available_choices(const Board& board, bool is_max){
-    int choices = board.get_valid_moves().size();
+    int choices = board.valid_move_list().size();
     return is_max ? choices : -choices; 
 }
 
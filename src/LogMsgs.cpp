@@ -78,6 +78,19 @@ void log_ordering_stats(const char* label, const OrderingStats& s) {
         double avg_best = double(s.best_idx_sum) / double(s.no_cutoff_nodes);
         o << " avgBestIdx(no-cut)=" << avg_best;
     }
+    if (s.region_solved) o << " regionSolved=" << s.region_solved;
+    if (s.corridor_plies) o << " corridorPlies=" << s.corridor_plies;
+    if (s.dead_ends) o << " deadEnds=" << s.dead_ends;
+    if (s.immediate_wins) o << " immWins=" << s.immediate_wins;
+    if (s.threat_prunes) o << " threatPrunes=" << s.threat_prunes;
+    if (s.mate_cutoffs) o << " mateCuts=" << s.mate_cutoffs;
+    if (s.race_cutoffs) o << " raceCuts=" << s.race_cutoffs;
+    if (s.etc_cutoffs) o << " etc=" << s.etc_cutoffs;
+    if (s.iid_searches) o << " iid=" << s.iid_searches << " iidBest=" << s.iid_move_best;
+    if (s.lmr_reductions) o << " lmr=" << s.lmr_reductions << " lmrRe=" << s.lmr_researches;
+    if (s.futility_prunes) o << " futility=" << s.futility_prunes;
+    if (s.razor_prunes) o << " razor=" << s.razor_prunes;
+    if (s.extensions) o << " ext=" << s.extensions;
     o << "\n";
 }
 } // namespace AI
@@ -0,0 +1,266 @@
+// ============================================================================
+// MCTS.cpp — Implementação do motor UCT
+// ----------------------------------------------------------------------------
+// Iteração: seleção (UCT) -> expansão (todos os filhos de uma vez) ->
+// simulação (playout até ao fim) -> retropropagação (vitória = 1 para quem
+// jogou para o nó). Células indexadas por r*cols + c.
+// ============================================================================
+
+#include "MCTS.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace {
+    inline bool test_bit(const std::array<uint64_t, 4>& m, int i) { return (m[i >> 6] >> (i & 63)) & 1ULL; }
+    inline void clear_bit(std::array<uint64_t, 4>& m, int i) { m[i >> 6] &= ~(1ULL << (i & 63)); }
+    inline void set_bit(std::array<uint64_t, 4>& m, int i) { m[i >> 6] |= (1ULL << (i & 63)); }
+
+    // xorshift64*: barato e sem estado partilhado entre threads
+    inline uint64_t next_rand(uint64_t& s) {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return s * 0x2545F4914F6CDD1DULL;
+    }
+}
+
+struct MCTS::Worker {
+    std::vector<Node> nodes;
+    uint64_t rng = 0;
+    uint64_t iterations = 0;
+    bool timed = false;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+MCTS::MCTS(bool is_max, MCTSConfig cfg) : is_max(is_max), cfg(cfg) {}
+
+void MCTS::prepare(const Board& board) {
+    const int R = board.get_rows(), C = board.get_cols();
+    if (geo.rows == R && geo.cols == C) return;
+
+    geo.rows = R;
+    geo.cols = C;
+    geo.max_goal = (R - 1) * C + 0;
+    geo.min_goal = 0 * C + (C - 1);
+    geo.adj.assign(R * C, {});
+    geo.adj_n.assign(R * C, 0);
+    geo.near_max_goal.assign(R * C, 0);
+    geo.near_min_goal.assign(R * C, 0);
+
+    for (int r = 0; r < R; ++r) {
+        for (int c = 0; c < C; ++c) {
+            const int i = r * C + c;
+            for (int dr = -1; dr <= 1; ++dr) {
+                for (int dc = -1; dc <= 1; ++dc) {
+                    if (dr == 0 && dc == 0) continue;
+                    int nr = r + dr, nc = c + dc;
+                    if (nr < 0 || nr >= R || nc < 0 || nc >= C) continue;
+                    const int j = nr * C + nc;
+                    geo.adj[i][geo.adj_n[i]++] = static_cast<int16_t>(j);
+                    if (j == geo.max_goal) geo.near_max_goal[i] = 1;
+                    if (j == geo.min_goal) geo.near_min_goal[i] = 1;
+                }
+            }
+        }
+    }
+}
+
+int MCTS::gen_moves(const State& s, int16_t* out) const {
+    int n = 0;
+    const auto& a = geo.adj[s.pos];
+    for (int k = 0; k < geo.adj_n[s.pos]; ++k) {
+        if (test_bit(s.free, a[k])) out[n++] = a[k];
+    }
+    return n;
+}
+
+int MCTS::winner_of(const State& s) const {
+    if (s.pos == geo.max_goal) return 1;
+    if (s.pos == geo.min_goal) return -1;
+    const auto& a = geo.adj[s.pos];
+    for (int k = 0; k < geo.adj_n[s.pos]; ++k) {
+        if (test_bit(s.free, a[k])) return 0;
+    }
+    return s.max_to_move ? -1 : 1;   // sem jogadas: quem joga perde
+}
+
+int MCTS::rollout_pick(const State& s, const int16_t* moves, int n, uint64_t& rng) const {
+    if (!cfg.heuristic_rollouts) return moves[next_rand(rng) % n];
+
+    const int own_goal = s.max_to_move ? geo.max_goal : geo.min_goal;
+    const int opp_goal = s.max_to_move ? geo.min_goal : geo.max_goal;
+    const auto& near_opp = s.max_to_move ? geo.near_min_goal : geo.near_max_goal;
+    const bool opp_goal_free = test_bit(s.free, opp_goal);
+
+    int16_t safe[8];
+    int n_safe = 0;
+    for (int i = 0; i < n; ++i) {
+        if (moves[i] == own_goal) return own_goal;
+        if (moves[i] == opp_goal || (opp_goal_free && near_opp[moves[i]])) continue;
+        safe[n_safe++] = moves[i];
+    }
+    if (n_safe == 0) return moves[next_rand(rng) % n];
+    return safe[next_rand(rng) % n_safe];
+}
+
+int MCTS::playout(State s, uint64_t& rng) const {
+    int16_t moves[8];
+    for (;;) {
+        if (s.pos == geo.max_goal) return 1;
+        if (s.pos == geo.min_goal) return -1;
+        const int n = gen_moves(s, moves);
+        if (n == 0) return s.max_to_move ? -1 : 1;
+        s.pos = rollout_pick(s, moves, n, rng);
+        clear_bit(s.free, s.pos);
+        s.max_to_move = !s.max_to_move;
+    }
+}
+
+void MCTS::run_worker(Worker& w, const State& root, uint64_t iterations) const {
+    auto& nodes = w.nodes;
+    nodes.clear();
+    nodes.reserve(std::max<std::size_t>(cfg.max_nodes, 16));
+    nodes.push_back(Node{});
+
+    int32_t path[kMaxCells + 2];
+    bool mover_max[kMaxCells + 2];
+    int16_t moves[8];
+
+    const double C = cfg.exploration;
+
+    for (uint64_t it = 0; iterations == 0 || it < iterations; ++it) {
+        if (w.timed && (it & 255) == 0 && std::chrono::steady_clock::now() >= w.deadline) break;
+
+        State s = root;
+        int len = 0;
+        int32_t cur = 0;
+        path[len] = 0;
+        mover_max[len++] = !root.max_to_move;
+        int winner = 0;
+
+        for (;;) {
+            winner = winner_of(s);
+            if (winner != 0) break;
+
+            Node& nd = nodes[cur];
+            if (nd.n_children < 0) {
+                const int n = gen_moves(s, moves);
+                if (nodes.size() + n > nodes.capacity()) {   // árvore cheia: só simula
+                    winner = playout(s, w.rng);
+                    break;
+                }
+                nd.first_child = static_cast<int32_t>(nodes.size());
+                nd.n_children = static_cast<int8_t>(n);
+                for (int i = 0; i < n; ++i) {
+                    Node ch;
+                    ch.cell = moves[i];
+                    nodes.push_back(ch);
+                }
+            }
+
+            // UCT; filhos por visitar primeiro
+            const Node& parent = nodes[cur];
+            int32_t best = -1;
+            double best_val = -1.0;
+            const double log_n = std::log(static_cast<double>(parent.visits) + 1.0);
+            for (int i = 0; i < parent.n_children; ++i) {
+                const int32_t idx = parent.first_child + i;
+                const Node& ch = nodes[idx];
+                if (ch.visits == 0) { best = idx; break; }
+                double v = ch.wins / ch.visits + C * std::sqrt(log_n / ch.visits);
+                if (v > best_val) { best_val = v; best = idx; }
+            }
+
+            const bool was_unvisited = nodes[best].visits == 0;
+            s.pos = nodes[best].cell;
+            clear_bit(s.free, s.pos);
+            mover_max[len] = s.max_to_move;
+            s.max_to_move = !s.max_to_move;
+            path[len++] = best;
+            cur = best;
+
+            if (was_unvisited) {
+                winner = winner_of(s);
+                if (winner == 0) winner = playout(s, w.rng);
+                break;
+            }
+        }
+
+        for (int i = 0; i < len; ++i) {
+            Node& nd = nodes[path[i]];
+            nd.visits++;
+            if ((winner > 0) == mover_max[i]) nd.wins += 1.f;
+        }
+        w.iterations++;
+    }
+}
+
+std::pair<int, int> MCTS::choose_move(Board& board, int /*depth_override*/, int /*rounds*/) {
+    const int R = board.get_rows(), C = board.get_cols();
+    auto valid = board.get_valid_moves();
+    if (valid.empty()) return {-1, -1};
+    if (R * C > kMaxCells || valid.size() == 1) return valid.front();
+
+    prepare(board);
+
+    State root{};
+    const auto& g = board.grid_ref();
+    for (int r = 0; r < R; ++r)
+        for (int c = 0; c < C; ++c)
+            if (g[r][c] == 1) set_bit(root.free, r * C + c);
+    const auto mk = board.get_marker();
+    root.pos = mk.first * C + mk.second;
+    clear_bit(root.free, root.pos);
+    root.max_to_move = is_max;
+
+    int threads = std::max(1, cfg.threads);
+    #if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    threads = 1;   // build WASM sem pthreads
+    #endif
+
+    uint64_t per_thread = cfg.playouts ? (cfg.playouts + threads - 1) / threads : 0;
+    if (per_thread == 0 && cfg.time_ms <= 0) per_thread = 1000;   // sem orçamento: valor seguro
+
+    uint64_t base_seed = cfg.seed;
+    if (base_seed == 0) base_seed = (uint64_t(std::random_device{}()) << 32) ^ std::random_device{}();
+
+    std::vector<Worker> workers(threads);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(cfg.time_ms);
+    for (int t = 0; t < threads; ++t) {
+        workers[t].rng = (base_seed + 0x9e3779b97f4a7c15ULL * (t + 1)) | 1ULL;
+        workers[t].timed = cfg.time_ms > 0;
+        workers[t].deadline = deadline;
+    }
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back([this, &workers, &root, per_thread, t]() {
+            run_worker(workers[t], root, per_thread);
+        });
+    }
+    run_worker(workers[0], root, per_thread);
+    for (auto& th : pool) th.join();
+
+    // Soma das visitas dos filhos da raiz de todas as árvores
+    std::vector<uint64_t> visits(R * C, 0);
+    playouts_done = 0;
+    for (const auto& w : workers) {
+        playouts_done += w.iterations;
+        const Node& rt = w.nodes.front();
+        for (int i = 0; i < rt.n_children; ++i) {
+            const Node& ch = w.nodes[rt.first_child + i];
+            visits[ch.cell] += ch.visits;
+        }
+    }
+
+    std::pair<int, int> best = valid.front();
+    uint64_t best_visits = 0;
+    for (const auto& mv : valid) {
+        uint64_t v = visits[mv.first * C + mv.second];
+        if (v > best_visits) { best_visits = v; best = mv; }
+    }
+    return best;
+}
@@ -0,0 +1,86 @@
+// ============================================================================
+// MCTS.hpp — Motor alternativo Monte Carlo Tree Search (UCT)
+// ----------------------------------------------------------------------------
+// Alternativa ao minimax do AI para tabuleiros grandes (9x9+), onde a
+// profundidade útil do alfa-beta deixa de caber no orçamento de latência.
+//
+// - Mesma forma de choose_move(Board&, depth_override, rounds) que o AI, para
+//   poder ser trocado no TestController e nos bindings.
+// - Playouts sem alocações: estado = máscara de bits das células livres +
+//   posição do marcador + lado a jogar, com vizinhanças pré-calculadas.
+// - Política de rollout opcional "heurística": entra no próprio objetivo
+//   quando possível e evita casas vizinhas do objetivo adversário.
+// - Paralelismo root-parallel: cada thread cresce a sua árvore; no fim somam-se
+//   as visitas dos filhos da raiz e escolhe-se o mais visitado.
+// - Orçamento por nº de iterações (playouts) e/ou por tempo.
+// - Tabuleiros até 256 células (16x16).
+// ============================================================================
+
+#pragma once
+#include "Board.hpp"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct MCTSConfig {
+    uint64_t playouts = 20000;      // iterações totais (somando threads); 0 = sem limite
+    int time_ms = 0;                // limite de tempo por jogada; 0 = sem limite
+    int threads = 1;                // threads root-parallel
+    double exploration = 1.41;      // constante C do UCT
+    bool heuristic_rollouts = false;
+    uint64_t seed = 0;              // 0 = semente aleatória
+    std::size_t max_nodes = 1u << 18;  // nós por árvore (por thread)
+};
+
+class MCTS {
+public:
+    explicit MCTS(bool is_max, MCTSConfig cfg = {});
+
+    // depth_override/rounds existem só para compatibilidade com AI::choose_move
+    std::pair<int, int> choose_move(Board& board, int depth_override = -1, int rounds = 0);
+
+    void set_config(const MCTSConfig& c) { cfg = c; }
+    const MCTSConfig& config() const { return cfg; }
+    uint64_t last_playouts() const { return playouts_done; }
+
+private:
+    static constexpr int kMaxCells = 256;
+    using FreeMask = std::array<uint64_t, kMaxCells / 64>;
+
+    struct State {
+        FreeMask free;   // células livres (a do marcador nunca está livre)
+        int pos;
+        bool max_to_move;
+    };
+
+    struct Node {
+        int32_t first_child = -1;
+        int16_t cell = -1;          // célula para onde se jogou
+        int8_t n_children = -1;     // -1 = ainda não expandido
+        uint32_t visits = 0;
+        float wins = 0.f;           // na perspetiva de quem jogou para este nó
+    };
+
+    struct Geometry {
+        int rows = 0, cols = 0;
+        int max_goal = 0, min_goal = 0;
+        std::vector<std::array<int16_t, 8>> adj;
+        std::vector<uint8_t> adj_n;
+        std::vector<uint8_t> near_max_goal, near_min_goal;
+    };
+
+    struct Worker;
+
+    void prepare(const Board& board);
+    void run_worker(Worker& w, const State& root, uint64_t iterations) const;
+    int winner_of(const State& s) const;          // +1 MAX, -1 MIN, 0 não terminal
+    int playout(State s, uint64_t& rng) const;    // devolve o vencedor
+    int gen_moves(const State& s, int16_t* out) const;
+    int rollout_pick(const State& s, const int16_t* moves, int n, uint64_t& rng) const;
+
+    bool is_max;
+    MCTSConfig cfg;
+    Geometry geo;
+    uint64_t playouts_done = 0;
+};
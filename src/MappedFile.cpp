@@ -0,0 +1,61 @@
+// ============================================================================
+// MappedFile.cpp — mmap (POSIX) com leitura integral como alternativa
+// ============================================================================
+
+#include "MappedFile.hpp"
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#if !defined(_WIN32)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // o mapeamento mantém-se válido após fechar o descritor
+    if (p != MAP_FAILED) {
+        ptr = static_cast<const unsigned char*>(p);
+        len = static_cast<std::size_t>(st.st_size);
+        mapped = true;
+        return true;
+    }
+#endif
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    std::streamsize n = in.tellg();
+    if (n <= 0) return false;
+    buffer.resize(static_cast<std::size_t>(n));
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(buffer.data()), n)) {
+        buffer.clear();
+        return false;
+    }
+    ptr = buffer.data();
+    len = buffer.size();
+    mapped = false;
+    return true;
+}
+
+void MappedFile::close() {
+#if !defined(_WIN32)
+    if (mapped && ptr) ::munmap(const_cast<unsigned char*>(ptr), len);
+#endif
+    ptr = nullptr;
+    len = 0;
+    mapped = false;
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
@@ -0,0 +1,34 @@
+// ============================================================================
+// MappedFile.hpp — Ficheiro só de leitura mapeado em memória
+// ----------------------------------------------------------------------------
+// Usado pelas tabelas pré-calculadas (base de dados de jogo perfeito, livro de
+// aberturas): o ficheiro é mapeado com mmap e as consultas leem diretamente
+// das páginas do SO, sem carregar tudo no arranque.
+// Em plataformas sem mmap (Windows) lê o ficheiro inteiro para memória.
+// ============================================================================
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return ptr != nullptr; }
+    const unsigned char* data() const { return ptr; }
+    std::size_t size() const { return len; }
+
+private:
+    const unsigned char* ptr = nullptr;
+    std::size_t len = 0;
+    bool mapped = false;                  // true -> munmap; false -> buffer
+    std::vector<unsigned char> buffer;
+};
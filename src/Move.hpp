@@ -0,0 +1,76 @@
+// ============================================================================
+// Move.hpp — Jogadas compactas (direção a partir do marcador)
+// ----------------------------------------------------------------------------
+// Toda a jogada é uma das 8 casas vizinhas do marcador, por isso cabe em
+// 3 bits (índice em kDirs, a mesma ordem de Board::get_valid_moves) e uma
+// lista ordenada de até 8 jogadas cabe num uint32_t:
+//
+//   bits 0..3   nº de jogadas
+//   bits 4..27  3 bits por jogada, pela ordem da lista
+//
+// std::pair<int,int> (Board::Move) fica para a API pública (bindings,
+// controladores, testes); a cache de ordenação do AI guarda só MoveList.
+// ============================================================================
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <utility>
+
+struct PackedMove {
+    // (dr, dc) por índice: ortogonais e depois diagonais
+    static constexpr int kDr[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    static constexpr int kDc[8] = { 0, 0, -1, 1, -1, 1, -1, 1};
+
+    uint8_t dir = 0;
+
+    // Direção de 'marker' para a casa vizinha 'to' (tem de ser vizinha)
+    static PackedMove between(const std::pair<int, int>& marker, const std::pair<int, int>& to) {
+        const int dr = to.first - marker.first, dc = to.second - marker.second;
+        for (uint8_t d = 0; d < 8; ++d) {
+            if (kDr[d] == dr && kDc[d] == dc) return PackedMove{d};
+        }
+        return PackedMove{};
+    }
+    std::pair<int, int> to(const std::pair<int, int>& marker) const {
+        return {marker.first + kDr[dir], marker.second + kDc[dir]};
+    }
+    bool operator==(const PackedMove& o) const { return dir == o.dir; }
+};
+
+class MoveList {
+public:
+    static constexpr int kMaxMoves = 8;
+
+    // Lista descodificada para um marcador (inline, sem alocação)
+    struct Decoded {
+        std::array<std::pair<int, int>, kMaxMoves> moves{};
+        int n = 0;
+        int size() const { return n; }
+        bool empty() const { return n == 0; }
+        const std::pair<int, int>& operator[](int i) const { return moves[i]; }
+        const std::pair<int, int>& front() const { return moves[0]; }
+        const std::pair<int, int>* begin() const { return moves.data(); }
+        const std::pair<int, int>* end() const { return moves.data() + n; }
+    };
+
+    int size() const { return static_cast<int>(bits & 0xF); }
+    bool empty() const { return size() == 0; }
+    PackedMove operator[](int i) const { return PackedMove{static_cast<uint8_t>((bits >> (4 + 3 * i)) & 0x7)}; }
+    void push_back(PackedMove m) {
+        const int n = size();
+        bits = (bits & ~0xFu) | static_cast<uint32_t>(n + 1);
+        bits |= static_cast<uint32_t>(m.dir) << (4 + 3 * n);
+    }
+    uint32_t raw() const { return bits; }
+
+    Decoded decode(const std::pair<int, int>& marker) const {
+        Decoded out;
+        out.n = size();
+        for (int i = 0; i < out.n; ++i) out.moves[i] = (*this)[i].to(marker);
+        return out;
+    }
+
+private:
+    uint32_t bits = 0;
+};
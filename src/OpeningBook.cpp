@@ -0,0 +1,237 @@
+// ============================================================================
+// OpeningBook.cpp — Consulta (mmap) e gerador offline do livro de aberturas
+// ============================================================================
+
+#include "OpeningBook.hpp"
+#include "AI.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+    constexpr uint32_t kMagic = 0x4B4F4252u;   // "RBOK"
+    constexpr uint32_t kVersion = 1;
+    constexpr uint64_t kMarkerSalt = 0x100000ULL;
+    constexpr uint64_t kSideSalt = 0xd6e8feb86659fd93ULL;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t rows;
+        uint32_t cols;
+        uint32_t plies;
+        uint32_t depth;
+        uint64_t count;
+    };
+    static_assert(sizeof(Header) == 32, "cabeçalho RBOK com 32 bytes");
+
+    // finalizador splitmix64: hash independente da Zobrist de cada Board
+    inline uint64_t mix(uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // Simetria t (como em PerfectPlayDB): 0 = identidade, 1 = anti-diagonal,
+    // 2 = diagonal (troca objetivos), 3 = rotação 180° (troca objetivos)
+    inline Board::Move map_rc(int r, int c, int t, int R, int C) {
+        switch (t) {
+            case 1: return {R - 1 - c, C - 1 - r};
+            case 2: return {c, r};
+            case 3: return {R - 1 - r, C - 1 - c};
+            default: return {r, c};
+        }
+    }
+}
+
+struct OpeningBook::Entry {
+    uint64_t key;
+    int16_t score;
+    uint8_t row;      // jogada no referencial canónico
+    uint8_t col;
+    uint32_t reserved;
+};
+
+Board::Move OpeningBook::map_move(const Board::Move& mv, int transform, int rows, int cols) {
+    return map_rc(mv.first, mv.second, transform, rows, cols);
+}
+
+uint64_t OpeningBook::canonical_key(const Board& b, bool mover_max, int* transform) {
+    const int R = b.get_rows(), C = b.get_cols();
+    const auto& g = b.grid_ref();
+    const auto mk = b.get_marker();
+    uint64_t best = 0;
+    int best_t = -1;
+    for (int t = 0; t <= 3; ++t) {
+        if ((t == 1 || t == 2) && R != C) continue;   // reflexões diagonais só em quadrados
+        uint64_t h = 0;
+        for (int r = 0; r < R; ++r)
+            for (int c = 0; c < C; ++c)
+                if (g[r][c] == 0) {
+                    auto p = map_rc(r, c, t, R, C);
+                    h ^= mix(uint64_t(p.first * C + p.second) + 1);
+                }
+        auto pm = map_rc(mk.first, mk.second, t, R, C);
+        h ^= mix(uint64_t(pm.first * C + pm.second) + kMarkerSalt);
+        const bool side = (t >= 2) ? !mover_max : mover_max;
+        if (side) h ^= kSideSalt;
+        if (best_t < 0 || h < best) { best = h; best_t = t; }
+    }
+    if (transform) *transform = best_t;
+    return best;
+}
+
+bool OpeningBook::open(const std::string& path) {
+    static_assert(sizeof(Entry) == 16, "entrada RBOK com 16 bytes");
+    count = 0;
+    entries = nullptr;
+    if (!file.open(path)) return false;
+    if (file.size() < sizeof(Header)) { file.close(); return false; }
+    Header h;
+    std::memcpy(&h, file.data(), sizeof(Header));
+    if (h.magic != kMagic || h.version != kVersion ||
+        file.size() != sizeof(Header) + h.count * sizeof(Entry)) {
+        file.close();
+        return false;
+    }
+    rows = int(h.rows);
+    cols = int(h.cols);
+    plies = int(h.plies);
+    depth = int(h.depth);
+    entries = reinterpret_cast<const Entry*>(file.data() + sizeof(Header));
+    count = h.count;
+    return true;
+}
+
+const OpeningBook::Entry* OpeningBook::find(uint64_t key) const {
+    const Entry* end = entries + count;
+    const Entry* it = std::lower_bound(entries, end, key,
+                                       [](const Entry& e, uint64_t k) { return e.key < k; });
+    return (it != end && it->key == key) ? it : nullptr;
+}
+
+bool OpeningBook::lookup(const Board& b, bool mover_max, Hit& out) const {
+    if (!is_open() || b.get_rows() != rows || b.get_cols() != cols) return false;
+    int t = 0;
+    const Entry* e = find(canonical_key(b, mover_max, &t));
+    if (!e) return false;
+
+    // as simetrias são involuções: a mesma transformação devolve a jogada real
+    const Board::Move mv = map_move({e->row, e->col}, t, rows, cols);
+    const auto valid = b.get_valid_moves();
+    if (std::find(valid.begin(), valid.end(), mv) == valid.end()) return false;   // colisão de hash
+    out.move = mv;
+    out.score = e->score;
+    out.depth = depth;
+    return true;
+}
+
+std::string OpeningBook::default_path(int rows, int cols) {
+    const char* dir = std::getenv("RASTROS_DATA_DIR");
+    std::string base = (dir && *dir) ? dir : "data";
+    return base + "/book_" + std::to_string(rows) + "x" + std::to_string(cols) + ".rbk";
+}
+
+namespace {
+    std::mutex loaded_mtx;
+    std::map<std::pair<int, int>, std::unique_ptr<OpeningBook>> loaded;   // nullptr = tentado e ausente
+}
+
+const OpeningBook* OpeningBook::for_size(int rows, int cols) {
+    std::lock_guard<std::mutex> lock(loaded_mtx);
+    auto it = loaded.find({rows, cols});
+    if (it == loaded.end()) {
+        auto book = std::make_unique<OpeningBook>();
+        if (!book->open(default_path(rows, cols)) || book->rows != rows || book->cols != cols) book.reset();
+        it = loaded.emplace(std::make_pair(rows, cols), std::move(book)).first;
+    }
+    return it->second.get();
+}
+
+void OpeningBook::rescan_missing() {
+    std::lock_guard<std::mutex> lock(loaded_mtx);
+    for (auto it = loaded.begin(); it != loaded.end();) {
+        it = it->second ? std::next(it) : loaded.erase(it);
+    }
+}
+
+uint64_t OpeningBook::build(int rows, int cols, int plies, int depth, int threads,
+                            const std::string& path, uint64_t* enumerated) {
+    if (rows < 2 || cols < 2 || rows > 255 || cols > 255 || plies < 1 || depth < 1) return 0;
+
+    struct Job {
+        Board board;
+        int ply;
+        int transform;
+        uint64_t key;
+    };
+
+    // 1) Enumeração por plies, expandindo só um representante por classe de simetria
+    std::vector<Job> jobs;
+    std::unordered_set<uint64_t> seen;
+    std::vector<Board> frontier{Board(rows, cols)};
+    uint64_t total = 0;
+    for (int ply = 1; ply <= plies && !frontier.empty(); ++ply) {
+        std::vector<Board> next;
+        for (const auto& b : frontier) {
+            for (const auto& mv : b.get_valid_moves()) {
+                Board child = b;
+                child.apply_move(mv);
+                if (child.is_terminal()) continue;
+                ++total;
+                int t = 0;
+                const uint64_t key = canonical_key(child, child.current_player_is_max(), &t);
+                if (!seen.insert(key).second) continue;
+                jobs.push_back(Job{child, ply, t, key});
+                next.push_back(std::move(child));
+            }
+        }
+        frontier.swap(next);
+    }
+    if (enumerated) *enumerated = total;
+
+    // 2) Procura de cada posição (uma AI nova por posição: resultado independente
+    //    do escalonamento das threads)
+    threads = std::max(1, threads);
+    #if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    threads = 1;   // build WASM sem pthreads
+    #endif
+
+    std::vector<Entry> out(jobs.size());
+    std::atomic<size_t> next_job{0};
+    auto worker = [&]() {
+        for (size_t i = next_job++; i < jobs.size(); i = next_job++) {
+            Job& j = jobs[i];
+            const bool mover_max = j.board.current_player_is_max();
+            AI ai(mover_max, depth);
+            ai.set_opening_book(false);
+            const auto mv = ai.choose_move(j.board, depth, j.ply);
+            const int score = std::max(-32767, std::min(32767, mover_max ? ai.last_score() : -ai.last_score()));
+            const auto cm = map_move(mv, j.transform, rows, cols);
+            out[i] = Entry{j.key, int16_t(score), uint8_t(cm.first), uint8_t(cm.second), 0};
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+
+    std::sort(out.begin(), out.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return 0;
+    Header h{kMagic, kVersion, uint32_t(rows), uint32_t(cols), uint32_t(plies), uint32_t(depth),
+             uint64_t(out.size())};
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    f.write(reinterpret_cast<const char*>(out.data()), std::streamsize(out.size() * sizeof(Entry)));
+    return f ? uint64_t(out.size()) : 0;
+}
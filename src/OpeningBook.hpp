@@ -0,0 +1,71 @@
+// ============================================================================
+// OpeningBook.hpp — Livro de aberturas pré-calculado (por tamanho de tabuleiro)
+// ----------------------------------------------------------------------------
+// Todos os jogos começam na mesma posição de Board(rows, cols), pelo que as
+// primeiras jogadas repetem sempre a mesma procura. O gerador offline
+// (tools/build_opening_book.cpp) enumera as posições a 1..N plies do início,
+// reduz por simetria, procura cada uma a profundidade alta (em paralelo) e
+// grava (chave -> jogada, score) num ficheiro ordenado consultado por mmap.
+//
+// - Chave: hash de 64 bits das casas bloqueadas + marcador + lado a jogar,
+//   mínima sobre as simetrias (as mesmas de PerfectPlayDB). A jogada é guardada
+//   no referencial canónico e desfeita na consulta (as simetrias são involuções).
+// - Score na perspetiva de quem joga (troca de lado nas simetrias que trocam
+//   os objetivos não altera o valor).
+// - Só é usado se a profundidade do livro for >= à pedida a choose_move.
+//
+// Formato: cabeçalho de 32 bytes ("RBOK", versão, rows, cols, plies, depth,
+// count) seguido de 'count' entradas de 16 bytes ordenadas pela chave.
+// ============================================================================
+
+#pragma once
+#include "Board.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <string>
+
+class OpeningBook {
+public:
+    struct Hit {
+        Board::Move move{-1, -1};
+        int score = 0;     // perspetiva de quem joga
+        int depth = 0;     // profundidade com que foi procurada
+    };
+
+    bool open(const std::string& path);
+    bool is_open() const { return count != 0; }
+    int get_rows() const { return rows; }
+    int get_cols() const { return cols; }
+    int get_plies() const { return plies; }
+    int get_depth() const { return depth; }
+    uint64_t size() const { return count; }
+
+    // Jogada do livro para quem joga (mover_max); false se ausente ou ilegal
+    bool lookup(const Board& b, bool mover_max, Hit& out) const;
+
+    // Livro para este tamanho ("<dir>/book_<R>x<C>.rbk", <dir> em RASTROS_DATA_DIR
+    // ou "data"); aberto uma vez e partilhado. nullptr se não houver (memorizado
+    // até rescan_missing(), como PerfectPlayDB::for_size).
+    static const OpeningBook* for_size(int rows, int cols);
+    static void rescan_missing();
+    static std::string default_path(int rows, int cols);
+
+    // Gerador offline: posições a 1..plies do início, cada uma procurada a
+    // 'depth' com 'threads' threads. Devolve o nº de entradas (0 = erro);
+    // 'enumerated' recebe o nº de posições antes da redução por simetria.
+    static uint64_t build(int rows, int cols, int plies, int depth, int threads,
+                          const std::string& path, uint64_t* enumerated = nullptr);
+
+    // Chave canónica e simetria que a produz (exposta para o gerador e testes)
+    static uint64_t canonical_key(const Board& b, bool mover_max, int* transform = nullptr);
+    static Board::Move map_move(const Board::Move& mv, int transform, int rows, int cols);
+
+private:
+    struct Entry;
+    const Entry* find(uint64_t key) const;
+
+    MappedFile file;
+    const Entry* entries = nullptr;
+    uint64_t count = 0;
+    int rows = 0, cols = 0, plies = 0, depth = 0;
+};
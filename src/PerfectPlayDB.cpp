@@ -0,0 +1,230 @@
+// ============================================================================
+// PerfectPlayDB.cpp — Consulta (mmap) e gerador offline da BD de jogo perfeito
+// ============================================================================
+
+#include "PerfectPlayDB.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    constexpr uint32_t kMagic = 0x42445052u;   // "RPDB"
+    constexpr uint32_t kVersion = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t rows;
+        uint32_t cols;
+        uint64_t count;
+        uint64_t reserved;
+    };
+    static_assert(sizeof(Header) == 32, "cabeçalho RPDB com 32 bytes");
+
+    inline uint64_t pack(uint64_t mask, int pos, bool mover_max) {
+        return mask | (uint64_t(pos) << 49) | (uint64_t(mover_max) << 55);
+    }
+
+    // Aplica a simetria t a uma célula: 0 = identidade, 1 = anti-diagonal,
+    // 2 = diagonal (troca objetivos), 3 = rotação 180° (troca objetivos)
+    inline int map_cell(int idx, int t, int R, int C) {
+        int r = idx / C, c = idx % C;
+        switch (t) {
+            case 1: return (R - 1 - c) * C + (C - 1 - r);
+            case 2: return c * C + r;
+            case 3: return (R - 1 - r) * C + (C - 1 - c);
+            default: return idx;
+        }
+    }
+
+    // Solver exato usado pelo gerador: memo pela chave canónica
+    struct Solver {
+        int R, C, N;
+        int max_goal, min_goal;
+        std::vector<std::array<int, 8>> adj;
+        std::vector<int> adj_n;
+        std::unordered_map<uint64_t, bool> memo;
+
+        Solver(int r, int c) : R(r), C(c), N(r * c), max_goal((r - 1) * c), min_goal(c - 1),
+                               adj(N), adj_n(N, 0) {
+            for (int i = 0; i < N; ++i) {
+                int ri = i / C, ci = i % C;
+                for (int dr = -1; dr <= 1; ++dr)
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        if (!dr && !dc) continue;
+                        int nr = ri + dr, nc = ci + dc;
+                        if (nr < 0 || nr >= R || nc < 0 || nc >= C) continue;
+                        adj[i][adj_n[i]++] = nr * C + nc;
+                    }
+            }
+        }
+
+        // true se quem joga ganha
+        bool solve(uint64_t free, int pos, bool mover_max) {
+            const int own = mover_max ? max_goal : min_goal;
+            const int opp = mover_max ? min_goal : max_goal;
+            for (int k = 0; k < adj_n[pos]; ++k) {
+                int j = adj[pos][k];
+                if (j == own && ((free >> j) & 1ULL)) return true;   // trivial: não guardado
+            }
+            const uint64_t key = PerfectPlayDB::canonical_key(free, pos, mover_max, R, C);
+            auto it = memo.find(key);
+            if (it != memo.end()) return it->second;
+
+            // sem corte na primeira vitória: todas as posições alcançáveis ficam
+            // resolvidas (o adversário pode desviar-se da linha de prova)
+            bool win = false;
+            for (int k = 0; k < adj_n[pos]; ++k) {
+                int j = adj[pos][k];
+                if (!((free >> j) & 1ULL) || j == opp) continue;
+                if (!solve(free & ~(1ULL << j), j, !mover_max)) win = true;
+            }
+            memo.emplace(key, win);   // sem jogadas (ou só o objetivo adversário) -> derrota
+            return win;
+        }
+    };
+}
+
+uint64_t PerfectPlayDB::canonical_key(uint64_t free_mask, int pos, bool mover_max, int R, int C) {
+    uint64_t best = pack(free_mask, pos, mover_max);
+    for (int t = 1; t <= 3; ++t) {
+        if (t != 3 && R != C) continue;   // reflexões diagonais só em quadrados
+        uint64_t m = 0;
+        for (uint64_t x = free_mask; x; x &= x - 1) {
+            int i = 0;
+            while (!((x >> i) & 1ULL)) ++i;
+            m |= 1ULL << map_cell(i, t, R, C);
+        }
+        const bool side = (t >= 2) ? !mover_max : mover_max;
+        best = std::min(best, pack(m, map_cell(pos, t, R, C), side));
+    }
+    return best;
+}
+
+uint64_t PerfectPlayDB::board_mask(const Board& b) {
+    const int R = b.get_rows(), C = b.get_cols();
+    const auto& g = b.grid_ref();
+    const auto mk = b.get_marker();
+    uint64_t m = 0;
+    for (int r = 0; r < R; ++r)
+        for (int c = 0; c < C; ++c)
+            if (g[r][c] == 1 && !(r == mk.first && c == mk.second)) m |= 1ULL << (r * C + c);
+    return m;
+}
+
+bool PerfectPlayDB::open(const std::string& path) {
+    count = 0;
+    entries = nullptr;
+    if (!file.open(path)) return false;
+    if (file.size() < sizeof(Header)) { file.close(); return false; }
+    Header h;
+    std::memcpy(&h, file.data(), sizeof(Header));
+    if (h.magic != kMagic || h.version != kVersion ||
+        file.size() != sizeof(Header) + h.count * sizeof(uint64_t) ||
+        !supports(int(h.rows), int(h.cols))) {
+        file.close();
+        return false;
+    }
+    rows = int(h.rows);
+    cols = int(h.cols);
+    entries = reinterpret_cast<const uint64_t*>(file.data() + sizeof(Header));
+    count = h.count;
+    return true;
+}
+
+PerfectPlayDB::Result PerfectPlayDB::lookup(uint64_t key) const {
+    uint64_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        uint64_t k = entries[mid] >> 1;
+        if (k < key) lo = mid + 1;
+        else if (k > key) hi = mid;
+        else return (entries[mid] & 1ULL) ? Result::Win : Result::Loss;
+    }
+    return Result::Unknown;
+}
+
+PerfectPlayDB::Result PerfectPlayDB::probe(const Board& b, bool mover_max) const {
+    if (!is_open() || b.get_rows() != rows || b.get_cols() != cols) return Result::Unknown;
+    const auto mk = b.get_marker();
+    if (b.threatens_goal(mk.first, mk.second, mover_max)) return Result::Win;
+    const uint64_t key = canonical_key(board_mask(b), mk.first * cols + mk.second, mover_max, rows, cols);
+    return lookup(key);
+}
+
+bool PerfectPlayDB::winning_move(const Board& b, bool mover_max, Board::Move& out) const {
+    if (!is_open() || b.get_rows() != rows || b.get_cols() != cols) return false;
+    const auto mk = b.get_marker();
+    const Board::Move own = mover_max ? Board::Move{rows - 1, 0} : Board::Move{0, cols - 1};
+    const Board::Move opp = mover_max ? Board::Move{0, cols - 1} : Board::Move{rows - 1, 0};
+    if (b.threatens_goal(mk.first, mk.second, mover_max)) { out = own; return true; }
+
+    const uint64_t mask = board_mask(b);
+    for (const auto& mv : b.get_valid_moves()) {
+        if (mv == opp) continue;
+        const int j = mv.first * cols + mv.second;
+        // filho: o adversário joga a partir de mv
+        if (b.threatens_goal(mv.first, mv.second, !mover_max)) continue;   // vitória imediata dele
+        const uint64_t key = canonical_key(mask & ~(1ULL << j), j, !mover_max, rows, cols);
+        if (lookup(key) == Result::Loss) { out = mv; return true; }
+    }
+    return false;
+}
+
+std::string PerfectPlayDB::default_path(int rows, int cols) {
+    const char* dir = std::getenv("RASTROS_DATA_DIR");
+    std::string base = (dir && *dir) ? dir : "data";
+    return base + "/perfect_" + std::to_string(rows) + "x" + std::to_string(cols) + ".rpdb";
+}
+
+namespace {
+    std::mutex loaded_mtx;
+    std::map<std::pair<int, int>, std::unique_ptr<PerfectPlayDB>> loaded;   // nullptr = tentado e ausente
+}
+
+const PerfectPlayDB* PerfectPlayDB::for_size(int rows, int cols) {
+    if (!supports(rows, cols)) return nullptr;
+
+    std::lock_guard<std::mutex> lock(loaded_mtx);
+    auto it = loaded.find({rows, cols});
+    if (it == loaded.end()) {
+        auto db = std::make_unique<PerfectPlayDB>();
+        if (!db->open(default_path(rows, cols)) || db->rows != rows || db->cols != cols) db.reset();
+        it = loaded.emplace(std::make_pair(rows, cols), std::move(db)).first;
+    }
+    return it->second.get();
+}
+
+void PerfectPlayDB::rescan_missing() {
+    std::lock_guard<std::mutex> lock(loaded_mtx);
+    for (auto it = loaded.begin(); it != loaded.end();) {
+        it = it->second ? std::next(it) : loaded.erase(it);
+    }
+}
+
+uint64_t PerfectPlayDB::build(int rows, int cols, const std::string& path) {
+    if (!supports(rows, cols)) return 0;
+    Board start(rows, cols);
+    Solver s(rows, cols);
+    const auto mk = start.get_marker();
+    s.solve(board_mask(start), mk.first * cols + mk.second, start.current_player_is_max());
+
+    std::vector<uint64_t> out;
+    out.reserve(s.memo.size());
+    for (const auto& kv : s.memo) out.push_back((kv.first << 1) | (kv.second ? 1ULL : 0ULL));
+    std::sort(out.begin(), out.end());
+
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return 0;
+    Header h{kMagic, kVersion, uint32_t(rows), uint32_t(cols), uint64_t(out.size()), 0};
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    f.write(reinterpret_cast<const char*>(out.data()), std::streamsize(out.size() * sizeof(uint64_t)));
+    return f ? uint64_t(out.size()) : 0;
+}
@@ -0,0 +1,67 @@
+// ============================================================================
+// PerfectPlayDB.hpp — Base de dados de jogo perfeito (tabuleiros pequenos)
+// ----------------------------------------------------------------------------
+// Gerada offline (tools/build_perfect_db.cpp): resolve todas as posições
+// alcançáveis a partir do início padrão de Board(rows, cols) e grava o
+// resultado (vitória/derrota de quem joga) num ficheiro ordenado que é
+// consultado por mmap + pesquisa binária.
+//
+// - Chave exata (sem colisões): células livres (máscara, ≤ 49 bits) + posição
+//   do marcador (6 bits) + lado a jogar (1 bit).
+// - Canónica por simetria: reflexão na anti-diagonal (preserva os objetivos)
+//   e reflexão na diagonal / rotação de 180° (trocam os objetivos -> troca-se
+//   também o lado a jogar). As duas primeiras só em tabuleiros quadrados.
+// - Posições triviais (quem joga entra já no objetivo) não são guardadas.
+//
+// Formato: cabeçalho de 32 bytes ("RPDB", versão, rows, cols, count, 0)
+// seguido de 'count' uint64 ordenados: (chave << 1) | vitória.
+// ============================================================================
+
+#pragma once
+#include "Board.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <string>
+
+class PerfectPlayDB {
+public:
+    enum class Result : uint8_t { Unknown, Win, Loss };
+
+    static bool supports(int rows, int cols) { return rows * cols <= 49; }
+
+    bool open(const std::string& path);
+    bool is_open() const { return count != 0; }
+    int get_rows() const { return rows; }
+    int get_cols() const { return cols; }
+    uint64_t size() const { return count; }
+
+    // Resultado para quem joga (mover_max) na posição dada
+    Result probe(const Board& b, bool mover_max) const;
+
+    // Jogada vencedora, se a posição for vitória conhecida para quem joga
+    bool winning_move(const Board& b, bool mover_max, Board::Move& out) const;
+
+    // BD para este tamanho (ficheiro "<dir>/perfect_<R>x<C>.rpdb", com <dir> em
+    // RASTROS_DATA_DIR ou "data"); aberta uma vez e partilhada. nullptr se não houver.
+    // A ausência também fica memorizada: um ficheiro gerado/copiado depois da
+    // primeira consulta só é visto após rescan_missing().
+    static const PerfectPlayDB* for_size(int rows, int cols);
+    // Volta a procurar os ficheiros que faltavam (as BD já abertas mantêm-se)
+    static void rescan_missing();
+    static std::string default_path(int rows, int cols);
+
+    // Gerador offline: resolve e grava; devolve o nº de posições guardadas (0 = erro)
+    static uint64_t build(int rows, int cols, const std::string& path);
+
+    // Codificação canónica (exposta para o gerador e testes)
+    static uint64_t canonical_key(uint64_t free_mask, int pos, bool mover_max, int rows, int cols);
+    static uint64_t board_mask(const Board& b);
+
+private:
+    Result lookup(uint64_t key) const;
+
+    MappedFile file;
+    const uint64_t* entries = nullptr;
+    uint64_t count = 0;
+    int rows = 0, cols = 0;
+};
@@ -0,0 +1,164 @@
+// ============================================================================
+// ProofNumberSearch.cpp — Implementação do df-pn
+// ----------------------------------------------------------------------------
+// - Filhos gerados uma vez por chamada a mid(): chave, e valores iniciais
+//   (terminal -> provado; na TT -> valor guardado; senão (1,1)).
+// - Os valores devolvidos pelas chamadas recursivas atualizam o array local,
+//   por isso o progresso não se perde se a entrada for substituída na TT.
+// - Limiares do filho escolhido (menor dn):
+//     thpn_c = thdn - dn + pn_c       (a soma dos pn não pode atingir thdn)
+//     thdn_c = min(thpn, dn2 + 1)     (dn2 = segundo menor dn)
+// ============================================================================
+
+#include "ProofNumberSearch.hpp"
+#include <algorithm>
+
+namespace {
+    // sal do lado a jogar: o hash de Zobrist do Board não o inclui
+    constexpr uint64_t kSideSalt = 0x9e3779b97f4a7c15ULL;
+
+    inline uint32_t sat_add(uint32_t a, uint32_t b, uint32_t inf) {
+        uint64_t s = uint64_t(a) + b;
+        return s >= inf ? inf : uint32_t(s);
+    }
+}
+
+ProofNumberSolver::ProofNumberSolver(std::size_t tt_entries) {
+    capacity = 1;
+    while (capacity < tt_entries) capacity <<= 1;
+}
+
+void ProofNumberSolver::clear() {
+    table.clear();
+    table.shrink_to_fit();
+}
+
+uint64_t ProofNumberSolver::key_of(const Board& b) {
+    return b.get_hash() ^ (b.current_player_is_max() ? kSideSalt : 0);
+}
+
+bool ProofNumberSolver::lookup(uint64_t key, uint32_t& pn, uint32_t& dn) const {
+    const Entry& e = table[key & (capacity - 1)];
+    if (e.key != key || (e.pn == 0 && e.dn == 0)) return false;
+    pn = e.pn;
+    dn = e.dn;
+    return true;
+}
+
+void ProofNumberSolver::store(uint64_t key, uint32_t pn, uint32_t dn) {
+    Entry& e = table[key & (capacity - 1)];
+    // não substituir uma prova de outra posição por um valor provisório
+    const bool slot_proven = (e.pn == 0 || e.dn == 0) && (e.pn | e.dn) != 0;
+    if (e.key != key && slot_proven && pn != 0 && dn != 0) return;
+    e.key = key;
+    e.pn = pn;
+    e.dn = dn;
+}
+
+int ProofNumberSolver::terminal(const Board& b) {
+    const bool mover_max = b.current_player_is_max();
+    const auto mk = b.get_marker();
+    const Board::Move max_goal{b.get_rows() - 1, 0};
+    const Board::Move min_goal{0, b.get_cols() - 1};
+
+    if (mk == max_goal) return mover_max ? 1 : 0;
+    if (mk == min_goal) return mover_max ? 0 : 1;
+    if (b.threatens_goal(mk.first, mk.second, /*max_goal=*/mover_max)) return 1;
+    if (b.free_neighbours(mk.first, mk.second) == 0) return 0;
+    return -1;
+}
+
+void ProofNumberSolver::mid(Board& b, uint64_t key, uint32_t thpn, uint32_t thdn,
+                            uint32_t& pn, uint32_t& dn, bool root) {
+    ++nodes;
+
+    static const int dr[8] = {-1,-1,-1, 0, 0, 1, 1, 1};
+    static const int dc[8] = {-1, 0, 1,-1, 1,-1, 0, 1};
+
+    Child ch[8];
+    int n = 0;
+    const auto mk = b.get_marker();
+    const auto& g = b.grid_ref();
+    for (int i = 0; i < 8; ++i) {
+        int r = mk.first + dr[i], c = mk.second + dc[i];
+        if (r < 0 || r >= b.get_rows() || c < 0 || c >= b.get_cols() || g[r][c] != 1) continue;
+        Child& x = ch[n++];
+        x.move = {r, c};
+        Board::MoveUndo u = b.apply_move(x.move);
+        x.key = key_of(b);
+        int t = terminal(b);
+        if (t == 1)      { x.pn = 0;    x.dn = kInf; }
+        else if (t == 0) { x.pn = kInf; x.dn = 0;    }
+        else if (!lookup(x.key, x.pn, x.dn)) { x.pn = 1; x.dn = 1; }
+        b.undo_move(u);
+    }
+
+    for (;;) {
+        pn = kInf;
+        dn = 0;
+        int best = -1;
+        uint32_t dn2 = kInf;
+        for (int i = 0; i < n; ++i) {
+            dn = sat_add(dn, ch[i].pn, kInf);
+            if (ch[i].dn < pn) {
+                dn2 = pn;
+                pn = ch[i].dn;
+                best = i;
+            } else if (ch[i].dn < dn2) {
+                dn2 = ch[i].dn;
+            }
+        }
+        if (pn == 0) dn = kInf;   // provado: normaliza para (0, ∞)
+
+        if (pn >= thpn || dn >= thdn || aborted || nodes >= budget) {
+            if (nodes >= budget) aborted = true;
+            if (root && pn == 0) root_move = ch[best].move;
+            store(key, pn, dn);
+            return;
+        }
+
+        Child& c = ch[best];
+        uint32_t c_thpn = sat_add(thdn - dn, c.pn, kInf);
+        uint32_t c_thdn = std::min(thpn, sat_add(dn2, 1, kInf));
+
+        Board::MoveUndo u = b.apply_move(c.move);
+        mid(b, c.key, c_thpn, c_thdn, c.pn, c.dn, /*root=*/false);
+        b.undo_move(u);
+    }
+}
+
+ProofNumberSolver::Verdict ProofNumberSolver::solve(const Board& board, uint64_t node_budget) {
+    Verdict v;
+    if (table.empty()) table.assign(capacity, Entry{});
+    nodes = 0;
+    budget = std::max<uint64_t>(node_budget, 1);
+    aborted = false;
+    root_move = {-1, -1};
+
+    Board b = board;
+    const int t = terminal(b);
+    if (t == 1) {
+        v.result = Result::Win;
+        const auto mk = b.get_marker();
+        if (b.threatens_goal(mk.first, mk.second, b.current_player_is_max())) {
+            v.move = b.current_player_is_max() ? Board::Move{b.get_rows() - 1, 0}
+                                               : Board::Move{0, b.get_cols() - 1};
+        }
+        return v;
+    }
+    if (t == 0) {
+        v.result = Result::Loss;
+        return v;
+    }
+
+    uint32_t pn = 0, dn = 0;
+    mid(b, key_of(b), kInf, kInf, pn, dn, /*root=*/true);
+    v.nodes = nodes;
+    if (pn == 0) {
+        v.result = Result::Win;
+        v.move = root_move;
+    } else if (dn == 0) {
+        v.result = Result::Loss;
+    }
+    return v;
+}
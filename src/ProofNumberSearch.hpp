@@ -0,0 +1,73 @@
+// ============================================================================
+// ProofNumberSearch.hpp — Solver exato por proof-number search (df-pn)
+// ----------------------------------------------------------------------------
+// Responde "quem joga ganha à força?" em vez de devolver um valor heurístico.
+// Usado pelo modo de problemas ("modo problemas") e para análise de finais.
+//
+// - df-pn (Nagai): pesquisa em profundidade com limiares (pn, dn), na
+//   perspetiva de quem joga em cada nó (forma negamax):
+//     pn = custo para provar vitória de quem joga  = min(dn dos filhos)
+//     dn = custo para refutar                      = soma(pn dos filhos)
+// - Tabela de transposição própria, de tamanho fixo (substituição por índice),
+//   independente da TT do minimax.
+// - Cada jogada bloqueia uma célula: o grafo de estados é acíclico, por isso
+//   não há problemas de ciclos (GHI).
+// ============================================================================
+
+#pragma once
+#include "Board.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class ProofNumberSolver {
+public:
+    // Resultado na perspetiva de quem joga na posição dada
+    enum class Result : uint8_t { Unknown, Win, Loss };
+
+    struct Verdict {
+        Result result = Result::Unknown;
+        Board::Move move{-1, -1};   // jogada que prova a vitória (só em Win)
+        uint64_t nodes = 0;         // nós expandidos nesta chamada
+    };
+
+    // tt_entries: nº de entradas da TT (arredondado para potência de 2);
+    // a memória só é reservada na primeira chamada a solve().
+    explicit ProofNumberSolver(std::size_t tt_entries = (1u << 18));
+
+    // Resolve a posição (quem joga = board.current_player_is_max()).
+    // Devolve Unknown se o orçamento de nós se esgotar antes da prova.
+    Verdict solve(const Board& board, uint64_t node_budget);
+
+    void clear();
+
+private:
+    static constexpr uint32_t kInf = 1u << 30;
+
+    struct Entry {
+        uint64_t key = 0;
+        uint32_t pn = 0, dn = 0;    // pn = dn = 0 -> entrada vazia
+    };
+
+    struct Child {
+        Board::Move move;
+        uint64_t key;
+        uint32_t pn, dn;            // na perspetiva de quem joga no filho
+    };
+
+    // Estado terminal na perspetiva de quem joga: 1 ganha, 0 perde, -1 não terminal
+    static int terminal(const Board& b);
+    static uint64_t key_of(const Board& b);
+
+    void mid(Board& b, uint64_t key, uint32_t thpn, uint32_t thdn,
+             uint32_t& pn, uint32_t& dn, bool root);
+    bool lookup(uint64_t key, uint32_t& pn, uint32_t& dn) const;
+    void store(uint64_t key, uint32_t pn, uint32_t dn);
+
+    std::size_t capacity;
+    std::vector<Entry> table;
+    uint64_t nodes = 0;
+    uint64_t budget = 0;
+    bool aborted = false;
+    Board::Move root_move{-1, -1};
+};
@@ -0,0 +1,64 @@
+// ============================================================================
+// RaceBounds.cpp — BFS com distâncias aos objetivos e plies mínimos de bloqueio
+// ============================================================================
+
+#include "RaceBounds.hpp"
+#include "SearchArena.hpp"
+#include <algorithm>
+#include <memory_resource>
+#include <vector>
+
+RaceBounds RaceBounds::compute(const Board& board, bool max_to_move) {
+    const int R = board.get_rows(), C = board.get_cols();
+    const auto& g = board.grid_ref();
+    const auto mk = board.get_marker();
+    const int max_goal = (R - 1) * C;
+    const int min_goal = C - 1;
+
+    // Scratch na arena da procura em curso (SearchArena), libertado à saída
+    SearchArena::Frame frame;
+    std::pmr::memory_resource* mr = SearchArena::current();
+    std::pmr::vector<int> dist(static_cast<size_t>(R) * C, -1, mr);
+    std::pmr::vector<int> queue(mr);
+    queue.reserve(static_cast<size_t>(R) * C);
+    const int start = mk.first * C + mk.second;
+    dist[start] = 0;
+    queue.push_back(start);
+
+    RaceBounds rb;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const int cell = queue[head];
+        const int r = cell / C, c = cell % C;
+        int free_nb = 0;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                if (dr == 0 && dc == 0) continue;
+                const int nr = r + dr, nc = c + dc;
+                if (nr < 0 || nr >= R || nc < 0 || nc >= C || g[nr][nc] != 1) continue;
+                const int n = nr * C + nc;
+                if (n == start) continue;   // a casa do marcador bloqueia-se no ply 1
+                ++free_nb;
+                if (dist[n] < 0) {
+                    dist[n] = dist[cell] + 1;
+                    queue.push_back(n);
+                }
+            }
+        }
+        if (cell == start) continue;
+
+        const int d = dist[cell];
+        if (cell == max_goal) { rb.max_win_ply = std::min(rb.max_win_ply, d); continue; }
+        if (cell == min_goal) { rb.min_win_ply = std::min(rb.min_win_ply, d); continue; }
+
+        // ply mínimo em que quem entra em 'cell' deixa o adversário sem jogadas
+        const int ply = free_nb == 0 ? d : std::max(1, d - 1) + free_nb;
+        // plies ímpares são de quem joga agora, pares do adversário
+        const int odd = ply | 1;
+        const int even = (ply + 1) & ~1;
+        int& own = max_to_move ? rb.max_win_ply : rb.min_win_ply;
+        int& opp = max_to_move ? rb.min_win_ply : rb.max_win_ply;
+        own = std::min(own, odd);
+        opp = std::min(opp, even);
+    }
+    return rb;
+}
@@ -0,0 +1,49 @@
+// ============================================================================
+// RaceBounds.hpp — Limites provados do valor do minimax (corrida aos objetivos)
+// ----------------------------------------------------------------------------
+// Cada ply move o marcador uma casa e bloqueia uma célula, pelo que as
+// distâncias BFS da posição atual (as mesmas de Board::compute_distance)
+// limitam o jogo por baixo:
+//
+// - Objetivo: ninguém entra no objetivo de MAX antes do ply |h1| (nem no de
+//   MIN antes de h5), seja quem for que lá entre.
+// - Bloqueio: para o adversário ficar sem jogadas na casa x, todos os f
+//   vizinhos livres de x têm de ser visitados antes de lá entrar. Daí o ply
+//   mínimo max(1, dist(x)-1) + f (ou dist(x) se f = 0; a casa do marcador
+//   não conta, bloqueia-se no ply 1), arredondado à paridade
+//   de quem joga nesse ply. O limite desce no máximo 1 por ply (consistente).
+//
+// Uma vitória no ply k vale 1000 - (depth + k - 1) (como adjust_terminal_score
+// nos pais), e as heurísticas ficam abaixo de kHeuristicBound; o valor de
+// qualquer nó fica então em [lower(depth), upper(depth)]. Os cortes são
+// exatos e ficam ligados em todos os modos.
+// ============================================================================
+
+#pragma once
+#include "Board.hpp"
+#include <algorithm>
+
+struct RaceBounds {
+    static constexpr int kNever = 1 << 20;        // vitória impossível
+    static constexpr int kHeuristicBound = 960;   // |heurística| abaixo disto
+
+    int max_win_ply = kNever;   // 1º ply em que MAX pode ganhar
+    int min_win_ply = kNever;   // 1º ply em que MIN pode ganhar
+
+    // Uma BFS a partir do marcador; max_to_move = quem joga o ply 1
+    static RaceBounds compute(const Board& board, bool max_to_move);
+
+    // Valor da vitória mais rápida possível (perspetiva MAX) num nó a 'depth'
+    int max_win_score(int depth) const { return 1000 - (depth + max_win_ply - 1); }
+    int min_win_score(int depth) const { return -(1000 - (depth + min_win_ply - 1)); }
+
+    // Limites do valor (perspetiva MAX) de um nó a 'depth'
+    int upper(int depth) const {
+        return max_win_ply == kNever ? kHeuristicBound
+                                     : std::max(kHeuristicBound, max_win_score(depth));
+    }
+    int lower(int depth) const {
+        return min_win_ply == kNever ? -kHeuristicBound
+                                     : std::min(-kHeuristicBound, min_win_score(depth));
+    }
+};
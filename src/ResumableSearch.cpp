@@ -0,0 +1,221 @@
+// ============================================================================
+// ResumableSearch.cpp — Minimax alfa-beta iterativo (pilha explícita) e escalonador
+// ============================================================================
+
+#include "ResumableSearch.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace {
+    constexpr int kInf = std::numeric_limits<int>::max();
+    constexpr int kNegInf = std::numeric_limits<int>::min();
+}
+
+ResumableSearch::ResumableSearch(const AI& prototype, const Board& b, int depth)
+    : ai(prototype), board(b), max_depth(std::max(1, depth)),
+      player_search(prototype.is_max ? 1 : 2) {
+    ai.aborted = false;
+    if (board.is_terminal()) { finished = true; return; }
+    const auto& root = ai.ordered_children(board, ai.is_max, /*depth*/0, max_depth, player_search);
+    if (root.empty()) { finished = true; return; }
+    result_move = root.front();   // fallback antes da 1ª iteração completa
+    start_iteration();
+}
+
+void ResumableSearch::start_iteration() {
+    ++iter_depth;
+    stack.clear();
+    have_value = false;
+    int value = 0;
+    // a raiz nunca é terminal (verificado no construtor) nem folha (iter_depth >= 1): tem Frame
+    enter(ai.is_max, /*depth*/0, kNegInf, kInf, value);
+}
+
+bool ResumableSearch::enter(bool is_max, int depth, int alpha, int beta, int& value) {
+    ++node_count;
+    ai.eval_successors++;
+    const int required = iter_depth - depth;
+    const CompactStateKey key = ai.compact_state_key(board, is_max, player_search);
+
+    Board::Move tt_move{-1, -1};
+    if (depth > 0) {
+        auto it = ai.tt.find(key);
+        if (it != ai.tt.end()) {
+            const TTEntry& c = it->second;
+            tt_move = c.best_move;
+            if (c.depth >= required) {
+                if (c.bound == TTBound::Exact) { value = c.value; return true; }
+                if (c.bound == TTBound::Lower && c.value >= beta) { value = c.value; return true; }
+                if (c.bound == TTBound::Upper && c.value <= alpha) { value = c.value; return true; }
+            }
+        }
+    } else if (auto it = ai.tt.find(key); it != ai.tt.end()) {
+        tt_move = it->second.best_move;   // raiz: só a ordenação (melhor da iteração anterior)
+    }
+
+    if (board.is_terminal()) {
+        value = ai.evaluate_terminal(board, is_max);
+        ai.tt[key] = TTEntry{ value, required, TTBound::Exact };
+        return true;
+    }
+    if (ai.use_goal_threats && depth > 0) {   // a raiz expande sempre (precisa da jogada)
+        const auto mk = board.get_marker();
+        if (board.threatens_goal(mk.first, mk.second, /*max_goal=*/is_max)) {
+            value = ai.adjust_terminal_score(is_max ? 1000 : -1000, depth);
+            ai.tt[key] = TTEntry{ value, AI::kExactDepth, TTBound::Exact };
+            return true;
+        }
+    }
+    if (depth >= iter_depth) {
+        if (ai.use_quiescence) {
+            value = ai.quiescence(board, is_max, alpha, beta, /*qdepth=*/0, /*base_depth=*/depth, player_search);
+        } else {
+            value = ai.leaf_heuristic(board, is_max, iter_depth, player_search);
+            ai.tt[key] = TTEntry{ value, 0, TTBound::Exact };
+        }
+        return true;
+    }
+
+    Frame f;
+    f.is_max = is_max;
+    f.depth = depth;
+    f.alpha = f.alpha0 = alpha;
+    f.beta = f.beta0 = beta;
+    f.best = is_max ? kNegInf : kInf;
+    f.key = key;
+    const auto& children = ai.ordered_children(board, is_max, depth, iter_depth, player_search);
+    for (const auto& ms : children) {
+        if (f.n_moves == static_cast<int>(f.moves.size())) break;
+        f.moves[f.n_moves++] = ms;
+    }
+    for (int i = 1; i < f.n_moves; ++i) {
+        if (f.moves[i] == tt_move) {
+            std::rotate(f.moves.begin(), f.moves.begin() + i, f.moves.begin() + i + 1);
+            break;
+        }
+    }
+    if (f.n_moves == 0) {   // não devia acontecer (não terminal)
+        value = ai.adjust_terminal_score(ai.total_heuristic(board, is_max), depth);
+        return true;
+    }
+    stack.push_back(f);
+    return false;
+}
+
+bool ResumableSearch::absorb(Frame& f, int child_value) {
+    // como no minimax: terminais do filho ajustados pela profundidade deste nó
+    // (a raiz conta como 1, tal como os filhos da raiz em choose_move)
+    const int score = ai.adjust_terminal_score(child_value, std::max(1, f.depth));
+    const Board::Move mv = f.moves[f.next - 1];
+    if (f.is_max) {
+        if (score >= f.beta) {
+            ai.tt[f.key] = TTEntry{ score, iter_depth - f.depth, TTBound::Lower, mv };
+            f.best = score;
+            f.best_move = mv;
+            return true;
+        }
+        f.alpha = std::max(f.alpha, score);
+        if (score > f.best) { f.best = score; f.best_move = mv; }
+    } else {
+        if (score <= f.alpha) {
+            ai.tt[f.key] = TTEntry{ score, iter_depth - f.depth, TTBound::Upper, mv };
+            f.best = score;
+            f.best_move = mv;
+            return true;
+        }
+        f.beta = std::min(f.beta, score);
+        if (score < f.best) { f.best = score; f.best_move = mv; }
+    }
+    if (f.next < f.n_moves) return false;
+
+    const TTBound bound = f.best <= f.alpha0 ? TTBound::Upper
+                        : f.best >= f.beta0  ? TTBound::Lower
+                                             : TTBound::Exact;
+    ai.tt[f.key] = TTEntry{ f.best, iter_depth - f.depth, bound, f.best_move };
+    return true;
+}
+
+bool ResumableSearch::step(uint64_t max_nodes, std::chrono::microseconds max_time) {
+    if (finished) return true;
+    SearchArena::Scope arena_scope(ai.ctx->arena);
+    const auto t0 = std::chrono::steady_clock::now();
+    const uint64_t node_limit = max_nodes ? node_count + max_nodes : 0;
+    uint64_t checks = 0;
+
+    while (true) {
+        if (have_value) {
+            have_value = false;
+            Frame& f = stack.back();
+            board.undo_move(f.undo);
+            if (!absorb(f, pending)) continue;
+
+            // nó resolvido: sobe o valor ao pai (ou fecha a iteração na raiz)
+            const Frame done = f;
+            stack.pop_back();
+            if (!stack.empty()) {
+                pending = done.best;
+                have_value = true;
+                continue;
+            }
+            result_move = done.best_move;
+            result_score = done.best;
+            completed = iter_depth;
+            const bool proven = std::abs(result_score) >= RaceBounds::kHeuristicBound;
+            if (iter_depth >= max_depth || proven) { finished = true; return true; }
+            start_iteration();
+            continue;
+        }
+
+        // fatia esgotada: sai entre dois nós (pilha e tabuleiro coerentes)
+        if (node_limit && node_count >= node_limit) return false;
+        if (max_time.count() > 0 && (++checks & 63) == 0 &&
+            std::chrono::steady_clock::now() - t0 >= max_time) return false;
+
+        Frame& f = stack.back();
+        const Board::Move mv = f.moves[f.next++];
+        f.undo = board.apply_move(mv);
+        const bool child_max = !f.is_max;
+        const int depth = f.depth + 1;
+        const int alpha = f.alpha, beta = f.beta;   // 'f' pode ser invalidada pelo push
+        int value = 0;
+        if (enter(child_max, depth, alpha, beta, value)) {
+            pending = value;
+            have_value = true;
+        }
+    }
+}
+
+int SearchScheduler::add(std::unique_ptr<ResumableSearch> search) {
+    searches.push_back(std::move(search));
+    return static_cast<int>(searches.size()) - 1;
+}
+
+int SearchScheduler::run_round() {
+    int running = 0;
+    for (auto& s : searches) {
+        if (!s || s->done()) continue;
+        if (!s->step(slice)) ++running;
+    }
+    return running;
+}
+
+int SearchScheduler::run_for(std::chrono::microseconds budget) {
+    const auto t0 = std::chrono::steady_clock::now();
+    int running = active();
+    while (running > 0 && std::chrono::steady_clock::now() - t0 < budget) running = run_round();
+    return running;
+}
+
+ResumableSearch* SearchScheduler::get(int id) {
+    return (id >= 0 && id < static_cast<int>(searches.size())) ? searches[id].get() : nullptr;
+}
+
+void SearchScheduler::remove(int id) {
+    if (id >= 0 && id < static_cast<int>(searches.size())) searches[id].reset();
+}
+
+int SearchScheduler::active() const {
+    int n = 0;
+    for (const auto& s : searches) if (s && !s->done()) ++n;
+    return n;
+}
@@ -0,0 +1,103 @@
+// ============================================================================
+// ResumableSearch.hpp — Alfa-beta com pilha explícita, retomável por fatias
+// ----------------------------------------------------------------------------
+// AI::choose_move é uma chamada recursiva bloqueante. Num anfitrião com uma só
+// thread (build WASM guiado pela UI, servidor com muitos jogos em poucas
+// threads) é preciso poder parar ao fim de N nós / N microssegundos e
+// continuar depois sem perder o estado.
+//
+// - A recursão do minimax passa a uma pilha de Frames (um por ply) e o
+//   tabuleiro é mantido com apply_move/undo_move; step() sai entre dois nós,
+//   com a pilha e o tabuleiro coerentes, e a chamada seguinte continua aí.
+// - Aprofundamento iterativo 1..max_depth; best_move() é o da última iteração
+//   completa (antes da 1ª, a primeira jogada ordenada).
+// - Mesmas convenções do minimax do AI que lhe serve de protótipo (é copiado):
+//   heurística, ordenação (ordered_children), TT, vitória a 1 passo e
+//   quiescence na folha (esta corre inteira dentro de um passo). Sem os
+//   extras seletivos (solvers, corredores, ETC, IID, LMR, futilidade).
+//
+// SearchScheduler reparte uma thread por várias procuras (round-robin de
+// fatias de nós), p.ex. um motor a servir dezenas de jogos em simultâneo.
+// ============================================================================
+
+#pragma once
+#include "AI.hpp"
+#include "Board.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class ResumableSearch {
+public:
+    ResumableSearch(const AI& prototype, const Board& board, int max_depth);
+
+    // Avança até 'max_nodes' nós (0 = sem limite) ou 'max_time' (0 = sem limite).
+    // Devolve true quando a procura terminou.
+    bool step(uint64_t max_nodes, std::chrono::microseconds max_time = std::chrono::microseconds{0});
+    bool done() const { return finished; }
+
+    std::pair<int, int> best_move() const { return result_move; }
+    int best_score() const { return result_score; }   // perspetiva de MAX
+    int completed_depth() const { return completed; }
+    uint64_t nodes() const { return node_count; }
+
+private:
+    struct Frame {
+        bool is_max;
+        int depth;
+        int alpha, beta;
+        int alpha0, beta0;                     // janela de entrada (tipo da entrada na TT)
+        int best;
+        Board::Move best_move{-1, -1};
+        std::array<Board::Move, 8> moves;
+        int n_moves = 0;
+        int next = 0;                          // próximo filho a visitar
+        Board::MoveUndo undo{};                // jogada em curso (filho na pilha)
+        CompactStateKey key;
+    };
+
+    // Entra num nó: true se o valor ficou logo em 'value' (sem Frame)
+    bool enter(bool is_max, int depth, int alpha, int beta, int& value);
+    // Recebe o valor do filho atual; true se o nó ficou resolvido (corte ou fim)
+    bool absorb(Frame& f, int child_value);
+    int finish(Frame& f);
+    void start_iteration();
+
+    AI ai;
+    Board board;
+    int max_depth;
+    int iter_depth = 0;
+    int player_search;
+    std::vector<Frame> stack;
+    bool have_value = false;   // há um valor de filho por entregar ao topo da pilha
+    int pending = 0;
+    bool finished = false;
+
+    std::pair<int, int> result_move{-1, -1};
+    int result_score = 0;
+    int completed = 0;
+    uint64_t node_count = 0;
+};
+
+// Escalonador cooperativo: várias procuras numa thread, por fatias de nós
+class SearchScheduler {
+public:
+    explicit SearchScheduler(uint64_t slice_nodes = 2000) : slice(slice_nodes) {}
+
+    int add(std::unique_ptr<ResumableSearch> search);   // devolve o id
+    // Uma fatia a cada procura por terminar; devolve quantas continuam ativas
+    int run_round();
+    // Rondas até esgotar 'budget' ou não restar trabalho
+    int run_for(std::chrono::microseconds budget);
+
+    ResumableSearch* get(int id);
+    void remove(int id);
+    int active() const;
+
+private:
+    uint64_t slice;
+    std::vector<std::unique_ptr<ResumableSearch>> searches;   // nullptr = removida
+};
@@ -0,0 +1,63 @@
+// ============================================================================
+// SearchArena.cpp — Blocos, marcas e arena ativa por thread
+// ============================================================================
+
+#include "SearchArena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+    thread_local SearchArena* t_active = nullptr;
+}
+
+std::size_t SearchArena::capacity() const {
+    std::size_t n = 0;
+    for (const auto& b : blocks) n += b.size;
+    return n;
+}
+
+void* SearchArena::do_allocate(std::size_t bytes, std::size_t align) {
+    // blocos já reservados (de uma procura anterior ou antes de um rewind) primeiro
+    while (current_block < blocks.size()) {
+        Block& b = blocks[current_block];
+        const auto base = reinterpret_cast<std::uintptr_t>(b.data.get());
+        const std::size_t start = ((base + offset + align - 1) & ~(std::uintptr_t(align) - 1)) - base;
+        if (start + bytes <= b.size) {
+            offset = start + bytes;
+            std::size_t used = offset;
+            for (std::size_t i = 0; i < current_block; ++i) used += blocks[i].size;
+            peak = std::max(peak, used);
+            return b.data.get() + start;
+        }
+        ++current_block;
+        offset = 0;
+    }
+    const std::size_t size = std::max(block_size, bytes + align);
+    blocks.push_back(Block{std::make_unique<std::byte[]>(size), size});
+    current_block = blocks.size() - 1;
+    offset = 0;
+    return do_allocate(bytes, align);
+}
+
+std::pmr::memory_resource* SearchArena::current() {
+    return t_active ? static_cast<std::pmr::memory_resource*>(t_active)
+                    : std::pmr::new_delete_resource();
+}
+
+SearchArena::Scope::Scope(SearchArena& arena) : prev(t_active), saved(arena.mark()) {
+    // reentrante: uma procura aninhada na mesma arena continua depois da marca
+    if (prev != &arena) arena.reset();
+    t_active = &arena;
+}
+
+SearchArena::Scope::~Scope() {
+    SearchArena* self = t_active;
+    t_active = prev;
+    if (prev == self) self->rewind(saved);   // aninhada: a procura de fora continua válida
+}
+
+SearchArena::Frame::Frame() : arena(t_active), saved(arena ? arena->mark() : Mark{}) {}
+
+SearchArena::Frame::~Frame() {
+    if (arena) arena->rewind(saved);
+}
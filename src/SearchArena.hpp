@@ -0,0 +1,84 @@
+// ============================================================================
+// SearchArena.hpp — Arena (bump allocator) para dados temporários da procura
+// ----------------------------------------------------------------------------
+// BFS do compute_distance, ruído da ordenação NoisyJitter, ... alocam e
+// libertam pequenos contentores em cada nó. A arena troca isso por um
+// ponteiro que avança dentro de blocos grandes (std::pmr::memory_resource):
+//
+// - Scope: liga a arena à thread durante uma procura (choose_move, analyse,
+//   um passo da ResumableSearch) e repõe-na a zero à entrada; current() é o
+//   recurso a usar nos contentores std::pmr (new/delete fora de uma procura).
+// - Frame: marca à entrada e volta à marca à saída (LIFO), para que o
+//   scratch de cada chamada não se acumule ao longo de milhões de nós.
+// - deallocate não faz nada; os blocos ficam para a procura seguinte.
+//
+// Cada AI tem a sua (SearchContext): uma cópia da AI começa com uma arena
+// vazia, e threads diferentes nunca partilham a mesma.
+// ============================================================================
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+class SearchArena : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t kDefaultBlock = 64 * 1024;
+
+    explicit SearchArena(std::size_t block_size = kDefaultBlock) : block_size(block_size) {}
+    SearchArena(const SearchArena& o) : std::pmr::memory_resource(), block_size(o.block_size) {}
+    SearchArena& operator=(const SearchArena&) { reset(); return *this; }
+
+    struct Mark {
+        std::size_t block = 0;
+        std::size_t offset = 0;
+    };
+    Mark mark() const { return {current_block, offset}; }
+    void rewind(const Mark& m) { current_block = m.block; offset = m.offset; }
+    void reset() { rewind(Mark{}); }
+
+    std::size_t capacity() const;                   // bytes reservados em blocos
+    std::size_t high_water() const { return peak; } // máximo em uso desde a criação
+
+    // Recurso da procura em curso nesta thread (ou new/delete)
+    static std::pmr::memory_resource* current();
+
+    class Scope {
+    public:
+        explicit Scope(SearchArena& arena);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        SearchArena* prev;
+        Mark saved;
+    };
+
+    class Frame {
+    public:
+        Frame();
+        ~Frame();
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+    private:
+        SearchArena* arena;
+        Mark saved;
+    };
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size = 0;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t align) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override { return this == &o; }
+
+    std::size_t block_size;
+    std::vector<Block> blocks;
+    std::size_t current_block = 0;
+    std::size_t offset = 0;
+    std::size_t peak = 0;
+};
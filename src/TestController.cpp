@@ -4,6 +4,7 @@
 #include <utility>
 #include <stdexcept>
 #include <algorithm>
+#include <chrono>
 #include "HeuristicsUtils.hpp"
 #include "AI.hpp"
 #include "LogMsgs.hpp"
@@ -55,6 +56,42 @@ void TestController::configure_quiescence(bool max_on, bool min_on,
     ai_player_2.set_quiescence(min_on, max_plies, swing_delta, low_mob);
 }
 
+void TestController::configure_lmr(bool max_on, bool min_on) {
+    ai_player.set_lmr(max_on);
+    ai_player_2.set_lmr(min_on);
+}
+
+void TestController::configure_extensions(bool max_on, bool min_on) {
+    ai_player.set_extensions(max_on);
+    ai_player_2.set_extensions(min_on);
+}
+
+void TestController::configure_futility(bool max_on, bool min_on, const FutilityParams& p) {
+    ai_player.set_futility(max_on, p);
+    ai_player_2.set_futility(min_on, p);
+}
+
+void TestController::configure_node_budget(uint64_t nodes) {
+    ai_player.set_node_budget(nodes);
+    ai_player_2.set_node_budget(nodes);
+}
+
+void TestController::configure_seed(uint64_t seed) {
+    ai_player.set_seed(seed);
+    ai_player_2.set_seed(seed + 1);
+}
+
+void TestController::configure_clock(const TimeControl& tc) {
+    clock_p1 = TimeManager(tc);
+    clock_p2 = TimeManager(tc);
+}
+
+void TestController::configure_mcts(bool max_on, bool min_on, const MCTSConfig& cfg) {
+    // MCTS no lugar do minimax (mesma interface choose_move); a profundidade é ignorada.
+    if (max_on) mcts_player.emplace(true, cfg); else mcts_player.reset();
+    if (min_on) mcts_player_2.emplace(false, cfg); else mcts_player_2.reset();
+}
+
 void TestController::set_depth_limits_p1(int start, int max) {
     start_depth_p1 = start;
     max_depth_p1 = max;
@@ -91,7 +128,8 @@ bool TestController::run(int mode) {
     }
 
     // reiniciar contadores e caches para medições consistentes antes de cada bateria de jogos
-    AI::vs_lookups = AI::vs_hits = AI::vs_inserts = 0;
+    ai_player.reset_search_counters();
+    ai_player_2.reset_search_counters();
     ai_player.clear_tt();
     ai_player.clear_order_caches();
     ai_player.clear_s_heuristic_caches();
@@ -144,9 +182,8 @@ void TestController::play_ai_turn() {
 
     std::pair<int, int> move;
 
-    auto& ai = board.current_player_is_max() ? ai_player : ai_player_2;
     int depth = compute_depth_for_player(board.current_player_is_max());
-    move = ai.choose_move(board, depth, rounds);
+    move = engine_move(depth);
     board.make_move(move);
 
 }
@@ -164,11 +201,15 @@ void TestController::play_ai_vs_ai_turn_mode2() {
 }
 
 bool TestController::handle_terminal_state() {
-std::cout << "[Visited] lookups=" << AI::vs_lookups
-          << " hits=" << AI::vs_hits
-          << " inserts=" << AI::vs_inserts
-          << " hit_rate=" << (100.0 * AI::vs_hits / std::max<uint64_t>(1, AI::vs_lookups))
-          << "%\n"; // relatório da TT
+const auto& c1 = ai_player.search_context();
+const auto& c2 = ai_player_2.search_context();
+const uint64_t lookups = c1.vs_lookups + c2.vs_lookups;
+const uint64_t hits = c1.vs_hits + c2.vs_hits;
+std::cout << "[Visited] lookups=" << lookups
+          << " hits=" << hits
+          << " inserts=" << (c1.vs_inserts + c2.vs_inserts)
+          << " hit_rate=" << (100.0 * hits / std::max<uint64_t>(1, lookups))
+          << "%\n"; // relatório da TT (soma das duas IAs)
 
     auto mk = board.get_marker();
     if (mk == std::make_pair(board.get_rows()-1, 0)) {
@@ -208,21 +249,39 @@ std::pair<int, int> TestController::get_marker() {
 }
 
 int TestController::compute_depth() const {
-    int depth = std::min(start_depth + rounds / 5, max_depth);
-    depth = (depth % 2 == 0) ? depth - 1 : depth; // força profundidade ímpar 
-    return std::max(depth, start_depth);
+    return TimeManager::scheduled_depth(start_depth, max_depth, rounds);
 }
 
 int TestController::compute_depth_for_player(bool is_max) const {
     int s = is_max ? start_depth_p1 : start_depth_p2;
     int m = is_max ? max_depth_p1 : max_depth_p2;
-    int depth = std::min(s + rounds / 5, m);
-    depth = (depth % 2 == 0) ? depth - 1 : depth; // força ímpar
-    return std::max(depth, s);
+    // com relógio a profundidade máxima é só o teto: quem pára é o orçamento de tempo
+    if ((is_max ? clock_p1 : clock_p2).enabled()) return m;
+    return TimeManager::scheduled_depth(s, m, rounds);
+}
+
+std::pair<int, int> TestController::engine_move(int depth) {
+    const bool is_max = board.current_player_is_max();
+    auto& mcts = is_max ? mcts_player : mcts_player_2;
+    if (mcts) return mcts->choose_move(board, depth, rounds);
+    auto& ai = is_max ? ai_player : ai_player_2;
+    auto& clock = is_max ? clock_p1 : clock_p2;
+    if (clock.enabled()) {
+        const auto budget = clock.allocate(board);
+        const auto t0 = std::chrono::steady_clock::now();
+        ai.set_time_budget(budget.soft_ms, budget.hard_ms);
+        auto move = ai.choose_move(board, depth, rounds);
+        ai.set_time_budget(0, 0);
+        clock.consume(static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - t0).count()));
+        return move;
+    }
+    if (move_time_ms > 0)
+        return ai.start_search(board, SearchLimits{depth, 0, move_time_ms, rounds}).wait().move;
+    return ai.choose_move(board, depth, rounds);
 }
 
 std::pair<int, int> TestController::select_ai_move(bool allow_first_override) {
-    auto& ai = board.current_player_is_max() ? ai_player : ai_player_2;
     if (allow_first_override && rounds == 0) {
         auto moves = board.get_valid_moves();
         auto it = std::find(moves.begin(), moves.end(), first_move);
@@ -235,5 +294,5 @@ std::pair<int, int> TestController::select_ai_move(bool allow_first_override) {
         if (!moves.empty()) return moves.front(); // fallback seguro se a jogada forçada não for válida
     }
     int depth = compute_depth_for_player(board.current_player_is_max());
-    return ai.choose_move(board, depth, rounds);
+    return engine_move(depth);
 }
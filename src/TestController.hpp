@@ -2,9 +2,12 @@
 #include "Board.hpp"
 #include "AI.hpp"
 #include "HeuristicsUtils.hpp"
+#include "MCTS.hpp"
+#include "TimeManager.hpp"
 #include <string>
 #include <vector>
 #include <utility>
+#include <optional>
 
 class TestController {
 public:
@@ -34,6 +37,29 @@ public:
     void configure_quiescence(bool max_on, bool min_on,
                           int max_plies = 4, int swing_delta = 2, int low_mob = 2);
 
+    // Late Move Reductions por lado (tabela por omissão do tamanho do tabuleiro)
+    void configure_lmr(bool max_on, bool min_on);
+    // Extensões seletivas (resposta única / corrida ao objetivo) por lado
+    void configure_extensions(bool max_on, bool min_on);
+
+    // Futilidade/razoring por lado (margens por omissão de FutilityParams)
+    void configure_futility(bool max_on, bool min_on, const FutilityParams& p = FutilityParams{});
+
+    // Procura limitada a 'nodes' nós (0 = sem limite) e sementes fixas: jogos
+    // reprodutíveis em qualquer máquina (a 2ª IA usa seed + 1)
+    void configure_node_budget(uint64_t nodes);
+    void configure_seed(uint64_t seed);
+    // Tempo por jogada em ms (0 = só profundidade): procura por start_search,
+    // interrompida no prazo com a jogada da última iteração completa
+    void configure_move_time(int ms) { move_time_ms = ms; }
+    // Relógio por lado (tempo total + incremento): substitui o calendário de
+    // profundidade, o orçamento de cada jogada vem do TimeManager
+    void configure_clock(const TimeControl& tc);
+    int clock_remaining_ms(bool is_max) const { return (is_max ? clock_p1 : clock_p2).remaining_ms(); }
+
+    // Troca o minimax pelo motor MCTS no(s) lado(s) indicado(s)
+    void configure_mcts(bool max_on, bool min_on, const MCTSConfig& cfg);
+
     void set_depth_limits(int start, int max);
     void set_depth_limits_p1(int start, int max);
     void set_depth_limits_p2(int start, int max);
@@ -50,6 +76,9 @@ private:
     int max_depth_p1 = 15;
     int start_depth_p2 = 9;
     int max_depth_p2 = 15;
+    int move_time_ms = 0;
+    TimeManager clock_p1;
+    TimeManager clock_p2;
     bool winner = false;
     std::pair<int, int>  first_move;
     HeuristicCombo combo_p1;
@@ -58,6 +87,8 @@ private:
     Board board;
     AI ai_player;
     AI ai_player_2;
+    std::optional<MCTS> mcts_player;
+    std::optional<MCTS> mcts_player_2;
     std::string mode;
 
     void play_ai_turn();
@@ -67,5 +98,6 @@ private:
     int compute_depth() const;
     int compute_depth_for_player(bool is_max) const;
     std::pair<int, int> select_ai_move(bool allow_first_override);
+    std::pair<int, int> engine_move(int depth);
     bool handle_terminal_state();
 };
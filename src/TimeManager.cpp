@@ -0,0 +1,44 @@
+// ============================================================================
+// TimeManager.cpp — Orçamento por jogada a partir do relógio e do tabuleiro
+// ============================================================================
+
+#include "TimeManager.hpp"
+#include <algorithm>
+
+int TimeManager::estimate_moves_left(const Board& board) {
+    const auto reach = board.compute_distance();
+    return std::max(kMinMovesLeft, reach.reachable_count / 2);
+}
+
+TimeManager::Budget TimeManager::allocate(const Board& board) const {
+    Budget b;
+    if (!enabled()) return b;
+    const int usable = std::max(1, clock_ms - kSafetyMs);
+
+    const int n_moves = static_cast<int>(board.valid_move_list().size());
+    if (n_moves <= 1) {   // jogada forçada: só o tempo de uma iteração
+        b.soft_ms = b.hard_ms = 1;
+        return b;
+    }
+
+    int soft = usable / estimate_moves_left(board) + tc.increment_ms * 3 / 4;
+    if (n_moves == 2) soft /= 2;
+    soft = std::max(1, std::min(soft, usable));
+
+    const int cap = std::max(soft, std::min(usable, usable / 2 + tc.increment_ms));
+    b.soft_ms = soft;
+    b.hard_ms = std::min(cap, soft * kHardFactor);
+    return b;
+}
+
+void TimeManager::consume(int elapsed_ms) {
+    if (!enabled()) return;
+    clock_ms -= elapsed_ms;
+    if (clock_ms >= 0) clock_ms += tc.increment_ms;
+}
+
+int TimeManager::scheduled_depth(int start, int max, int rounds) {
+    int depth = std::min(start + rounds / 5, max);
+    depth = (depth % 2 == 0) ? depth - 1 : depth;   // força profundidade ímpar
+    return std::max(depth, start);
+}
@@ -0,0 +1,58 @@
+// ============================================================================
+// TimeManager.hpp — Gestão do relógio de jogo (tempo total + incremento)
+// ----------------------------------------------------------------------------
+// Substitui o calendário fixo de profundidade (start + rounds/5, ímpar) quando
+// há relógio: cada jogada recebe um orçamento a partir do tempo que resta e
+// de uma estimativa das jogadas que faltam a quem joga.
+//
+// - Jogadas restantes: metade das casas livres da região do marcador
+//   (reachable_count de Board::compute_distance), pelo menos kMinMovesLeft.
+// - soft: alvo da jogada, clock / jogadas + 3/4 do incremento (menos com
+//   pouca escolha: 1 jogada legal = instantâneo, 2 = metade).
+// - hard: teto absoluto (a procura é cortada), até kHardFactor x soft sem
+//   passar de metade do relógio utilizável (+ incremento).
+//
+// O AI usa soft entre iterações (set_time_budget): se a melhor jogada da raiz
+// mudou na última iteração o alvo estica, se está estável encolhe.
+// ============================================================================
+
+#pragma once
+#include "Board.hpp"
+
+struct TimeControl {
+    int total_ms = 0;       // 0 = sem relógio (calendário de profundidade)
+    int increment_ms = 0;   // somado depois de cada jogada
+};
+
+class TimeManager {
+public:
+    struct Budget {
+        int soft_ms = 0;
+        int hard_ms = 0;
+    };
+
+    static constexpr int kMinMovesLeft = 4;
+    static constexpr int kSafetyMs = 30;     // margem para a latência fora da procura
+    static constexpr int kHardFactor = 4;
+
+    TimeManager() = default;
+    explicit TimeManager(const TimeControl& tc) : tc(tc), clock_ms(tc.total_ms) {}
+
+    bool enabled() const { return tc.total_ms > 0; }
+    int remaining_ms() const { return clock_ms; }
+    bool flagged() const { return enabled() && clock_ms < 0; }   // o tempo acabou
+
+    // Orçamento para a jogada de quem está a jogar em 'board'
+    Budget allocate(const Board& board) const;
+    // Desconta o tempo gasto e soma o incremento
+    void consume(int elapsed_ms);
+
+    // Jogadas que ainda faltam a quem joga (estimativa)
+    static int estimate_moves_left(const Board& board);
+    // Calendário sem relógio: min(start + rounds/5, max), forçado a ímpar
+    static int scheduled_depth(int start, int max, int rounds);
+
+private:
+    TimeControl tc;
+    int clock_ms = 0;
+};
@@ -1,6 +1,12 @@
 #include <emscripten/bind.h>
+#include <emscripten/val.h>
 #include "Board.hpp"
 #include "AI.hpp"
+#include "MCTS.hpp"
+#include "ResumableSearch.hpp"
+#include "Calibration.hpp"
+#include "PerfectPlayDB.hpp"
+#include "OpeningBook.hpp"
 
 using namespace emscripten;
 
@@ -17,6 +23,23 @@ EMSCRIPTEN_BINDINGS(rastros_module) {
     //last changes
     function("initHeuristics", &AI::register_heuristics);
     function("createAIWithLevel", &AI::create_with_level);
+    // Profundidade para ~targetMs por jogada neste cliente (benchmark curto, 1x por tamanho)
+    function("calibrate", optional_override([](int rows, int cols, int target_ms) {
+        const Calibration cal = Calibration::for_size(rows, cols);
+        const auto lim = cal.depth_for(target_ms);
+        val o = val::object();
+        o.set("nps", cal.nps);
+        o.set("ebf", cal.ebf);
+        o.set("startDepth", lim.start_depth);
+        o.set("maxDepth", lim.max_depth);
+        return o;
+    }));
+    // Volta a procurar tabelas de data/ que faltavam na primeira consulta
+    // (p.ex. descarregadas depois de o módulo arrancar)
+    function("rescanTables", optional_override([]() {
+        PerfectPlayDB::rescan_missing();
+        OpeningBook::rescan_missing();
+    }));
     //
 
     enum_<OrderingPolicy>("OrderingPolicy")
@@ -49,16 +72,120 @@ EMSCRIPTEN_BINDINGS(rastros_module) {
         // ============
         ;
 
+    // Solver exato (modo problemas)
+    enum_<ProofNumberSolver::Result>("SolveResult")
+    .value("Unknown", ProofNumberSolver::Result::Unknown)
+    .value("Win", ProofNumberSolver::Result::Win)
+    .value("Loss", ProofNumberSolver::Result::Loss);
+
+    value_object<ProofNumberSolver::Verdict>("SolveVerdict")
+        .field("result", &ProofNumberSolver::Verdict::result)
+        .field("move", &ProofNumberSolver::Verdict::move);
+
+    // A AI da UI usa as tabelas pré-calculadas, se existirem (no motor são opcionais)
     class_<AI>("AI")
-        .constructor<bool, int>()
+        .constructor(optional_override([](bool is_max, int depth) {
+            AI* ai = new AI(is_max, depth);
+            ai->set_perfect_db(true);
+            ai->set_opening_book(true);
+            return ai;
+        }), allow_raw_pointers())
         .function("chooseMove", static_cast<std::pair<int, int> (AI::*)(Board&, int, int)>(&AI::choose_move))
         .function("setOrderingPolicy", &AI::set_ordering_policy)
         .function("setShuffleTiesOnly", &AI::set_shuffle_ties_only)
         .function("setOrderNoise", &AI::set_order_noise)
         .function("setQuiescence", &AI::set_quiescence)
+        .function("setPerfectDB", &AI::set_perfect_db)
+        .function("setOpeningBook", &AI::set_opening_book)
+        .function("solve", optional_override([](AI& ai, const Board& b, double node_budget) {
+            return ai.solve(b, static_cast<uint64_t>(node_budget));
+        }))
+        .function("solveWinLoss", optional_override([](AI& ai, const Board& b, double node_budget) {
+            return ai.solve_wl(b, static_cast<uint64_t>(node_budget));
+        }))
+        // Multi-PV (dicas/análise): [{move, score, depth, seldepth, pv, nodes}], melhor primeiro
+        .function("analyse", optional_override([](AI& ai, const Board& b, int k, int depth, double node_budget) {
+            val out = val::array();
+            for (const auto& l : ai.analyse(b, k, AnalysisLimits{depth, static_cast<uint64_t>(node_budget)})) {
+                val pv = val::array();
+                for (const auto& mv : l.pv) pv.call<void>("push", mv);
+                val o = val::object();
+                o.set("move", l.move);
+                o.set("score", l.score);
+                o.set("depth", l.depth);
+                o.set("seldepth", l.seldepth);
+                o.set("pv", pv);
+                o.set("nodes", static_cast<double>(l.nodes));
+                out.call<void>("push", o);
+            }
+            return out;
+        }))
+        .function("startSearch", optional_override([](AI& ai, const Board& b, int depth, double nodes,
+                                                       int time_ms, int rounds) {
+            return std::make_shared<SearchHandle>(
+                ai.start_search(b, SearchLimits{depth, static_cast<uint64_t>(nodes), time_ms, rounds}));
+        }))
         .function("clearTT", &AI::clear_tt)
         .function("clearOrderCaches", &AI::clear_order_caches)
         .function("clearSuccessorHeuristicCaches", &AI::clear_s_heuristic_caches)
         .function("setDebugLevel", &AI::set_debug_level)
         .function("getDebugLevel", &AI::get_debug_level);
+
+    // Procura assíncrona: a UI faz polling de lastProgress()/ready() e pode parar
+    class_<SearchHandle>("SearchHandle")
+        .smart_ptr<std::shared_ptr<SearchHandle>>("SearchHandlePtr")
+        .function("stop", &SearchHandle::stop)
+        .function("ready", &SearchHandle::ready)
+        .function("wait", optional_override([](SearchHandle& h) {
+            const SearchResult r = h.wait();
+            val o = val::object();
+            o.set("move", r.move);
+            o.set("score", r.score);
+            o.set("depth", r.depth);
+            o.set("nodes", static_cast<double>(r.nodes));
+            o.set("stopped", r.stopped);
+            return o;
+        }))
+        .function("lastProgress", optional_override([](const SearchHandle& h) {
+            const SearchProgress p = h.last_progress();
+            val pv = val::array();
+            for (const auto& mv : p.pv) pv.call<void>("push", mv);
+            val o = val::object();
+            o.set("depth", p.depth);
+            o.set("score", p.score);
+            o.set("nodes", static_cast<double>(p.nodes));
+            o.set("nps", p.nps);
+            o.set("bestMove", p.best_move);
+            o.set("pv", pv);
+            return o;
+        }));
+
+    // Procura retomável: a UI chama step() a cada frame sem bloquear a thread principal
+    class_<ResumableSearch>("ResumableSearch")
+        .constructor<const AI&, const Board&, int>()
+        .function("step", optional_override([](ResumableSearch& s, double max_nodes, double max_us) {
+            return s.step(static_cast<uint64_t>(max_nodes),
+                          std::chrono::microseconds(static_cast<int64_t>(max_us)));
+        }))
+        .function("done", &ResumableSearch::done)
+        .function("bestMove", &ResumableSearch::best_move)
+        .function("bestScore", &ResumableSearch::best_score)
+        .function("completedDepth", &ResumableSearch::completed_depth);
+
+    // Motor alternativo (MCTS); sem pthreads no build WASM corre numa só thread
+    value_object<MCTSConfig>("MCTSConfig")
+        .field("timeMs", &MCTSConfig::time_ms)
+        .field("threads", &MCTSConfig::threads)
+        .field("exploration", &MCTSConfig::exploration)
+        .field("heuristicRollouts", &MCTSConfig::heuristic_rollouts);
+
+    class_<MCTS>("MCTS")
+        .constructor<bool>()
+        .constructor<bool, MCTSConfig>()
+        .function("chooseMove", &MCTS::choose_move)
+        .function("setPlayouts", optional_override([](MCTS& m, double playouts) {
+            MCTSConfig c = m.config();
+            c.playouts = static_cast<uint64_t>(playouts);
+            m.set_config(c);
+        }));
 }
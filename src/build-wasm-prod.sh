@@ -15,7 +15,7 @@ export EM_CACHE="$EM_CACHE_DIR"
 
 # Build de produção: sem ASSERTIONS, debug a 0, otimização máxima
 em++ \
-  bindings.cpp Board.cpp AI.cpp HeuristicsUtils.cpp LogMsgs.cpp \
+  bindings.cpp Board.cpp AI.cpp HeuristicsUtils.cpp LogMsgs.cpp EndgameSolver.cpp ProofNumberSearch.cpp MCTS.cpp PerfectPlayDB.cpp OpeningBook.cpp MappedFile.cpp RaceBounds.cpp ResumableSearch.cpp Calibration.cpp SearchArena.cpp \
   -o "$OUTPUT_DIR/game.js" \
   -s MODULARIZE=1 \
   -s EXPORT_NAME="createGameModule" \
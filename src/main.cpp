@@ -12,6 +12,7 @@
 #include <cctype>
 #include "HeuristicsUtils.hpp"
 #include "LogMsgs.hpp"
+#include "Calibration.hpp"
 
 
 //input helpers
@@ -52,7 +53,12 @@ static std::vector<std::string> strip_new_flags(int argc, char* argv[]) {
             a == "-c" || a == "--col" ||
             a == "-h" || a == "--heur" ||
             a == "-h1" || a == "--heur1" ||
-            a == "-h2" || a == "--heur2") {
+            a == "-h2" || a == "--heur2" ||
+            a == "-q" || a == "--quiescence" ||
+            a == "--mcts1" || a == "--mcts2" ||
+            a == "--mcts-threads" || a == "--mcts-ms" ||
+            a == "--nodes" || a == "--seed" || a == "--move-ms" ||
+            a == "--clock" || a == "--inc" || a == "--target-ms") {
             // skip this and the next (its value), if present
             ++i;
             continue;
@@ -67,7 +73,21 @@ static std::vector<std::string> strip_new_flags(int argc, char* argv[]) {
             a.rfind("--col=", 0) == 0 ||
             a.rfind("--heur=", 0) == 0 ||
             a.rfind("--heur1=", 0) == 0 ||
-            a.rfind("--heur2=", 0) == 0) {
+            a.rfind("--heur2=", 0) == 0 ||
+            a.rfind("--quiescence=", 0) == 0 ||
+            a.rfind("--mcts1=", 0) == 0 ||
+            a.rfind("--mcts2=", 0) == 0 ||
+            a.rfind("--mcts-threads=", 0) == 0 ||
+            a.rfind("--mcts-ms=", 0) == 0 ||
+            a.rfind("--nodes=", 0) == 0 ||
+            a.rfind("--seed=", 0) == 0 ||
+            a.rfind("--move-ms=", 0) == 0 ||
+            a.rfind("--clock=", 0) == 0 ||
+            a.rfind("--inc=", 0) == 0 ||
+            a.rfind("--target-ms=", 0) == 0 ||
+            a == "--no-calibrate" ||
+            a == "--mcts-heur" ||
+            a == "--lmr" || a == "--futility" || a == "--ext") {
             continue;
         }
         out.push_back(a);
@@ -156,6 +176,27 @@ struct QuiescenceConfig {
     int lowmob = 2;
 };
 
+// Motor MCTS por lado (em vez do minimax)
+struct MCTSSetup {
+    bool enableMax = false;
+    bool enableMin = false;
+    MCTSConfig cfg{};
+};
+
+// Podas/reduções seletivas (desligadas por omissão)
+struct SelectiveSetup {
+    bool lmr = false;
+    bool futility = false;
+    bool extensions = false;
+};
+
+struct BudgetSetup {
+    uint64_t nodes = 0;              // 0 = sem limite de nós
+    int move_ms = 0;                 // 0 = sem limite de tempo
+    TimeControl clock;               // relógio por lado (total_ms = 0: desligado)
+    std::optional<uint64_t> seed;    // semente do jogo (AI 2 usa seed + 1)
+};
+
 static OrderingConfig parse_ordering_config(int cargc, const std::vector<char*>& cargv) {
     OrderingConfig cfg;
     if (cargc >= 4) cfg.pMax = parse_policy(cargv[3]);
@@ -182,6 +223,39 @@ static void apply_quiescence(TestController& controller, const QuiescenceConfig&
     print_quiescence_header(cfg.enableMax, cfg.enableMin, cfg.plies, cfg.swing, cfg.lowmob);
 }
 
+static void apply_mcts(TestController& controller, const MCTSSetup& m) {
+    if (!m.enableMax && !m.enableMin) return;
+    controller.configure_mcts(m.enableMax, m.enableMin, m.cfg);
+    std::cout << "[MCTS] MAX=" << (m.enableMax ? "on" : "off")
+              << ", MIN=" << (m.enableMin ? "on" : "off")
+              << " (playouts=" << m.cfg.playouts << ", ms=" << m.cfg.time_ms
+              << ", threads=" << m.cfg.threads
+              << (m.cfg.heuristic_rollouts ? ", heur" : "") << ")\n";
+}
+
+static void apply_selective(TestController& controller, const SelectiveSetup& sel) {
+    if (!sel.lmr && !sel.futility && !sel.extensions) return;
+    controller.configure_lmr(sel.lmr, sel.lmr);
+    controller.configure_futility(sel.futility, sel.futility);
+    controller.configure_extensions(sel.extensions, sel.extensions);
+    std::cout << "[Selective] lmr=" << (sel.lmr ? "on" : "off")
+              << ", futility=" << (sel.futility ? "on" : "off")
+              << ", ext=" << (sel.extensions ? "on" : "off") << "\n";
+}
+
+static void apply_budget(TestController& controller, const BudgetSetup& b) {
+    if (b.nodes) controller.configure_node_budget(b.nodes);
+    if (b.seed) controller.configure_seed(*b.seed);
+    if (b.move_ms) controller.configure_move_time(b.move_ms);
+    if (b.clock.total_ms) controller.configure_clock(b.clock);
+    if (b.nodes || b.seed || b.move_ms || b.clock.total_ms) {
+        std::cout << "[Budget] nodes=" << b.nodes << ", move_ms=" << b.move_ms;
+        if (b.clock.total_ms) std::cout << ", clock=" << b.clock.total_ms << "+" << b.clock.increment_ms;
+        if (b.seed) std::cout << ", seed=" << *b.seed;
+        std::cout << "\n";
+    }
+}
+
 static void apply_depth_overrides(TestController& controller,
                                   const std::optional<int>& depthFlag,
                                   const std::optional<int>& maxDepthFlag,
@@ -202,12 +276,41 @@ static void apply_depth_overrides(TestController& controller,
     controller.set_depth_limits_p2(start2, max2);
 }
 
+// Profundidade calibrada (Calibration) para ~target_ms por jogada nesta máquina;
+// as flags -d/-md explícitas têm prioridade
+static std::optional<Calibration::DepthLimits> calibrated_depth(int rows, int cols, int target_ms,
+                                                                const std::optional<int>& depthFlag,
+                                                                const std::optional<int>& maxDepthFlag) {
+    if (target_ms <= 0 || depthFlag || maxDepthFlag) return std::nullopt;
+    const Calibration cal = Calibration::for_size(rows, cols);
+    if (!cal.valid()) return std::nullopt;
+    const auto lim = cal.depth_for(target_ms);
+    std::cout << "[Calibration] " << rows << "x" << cols << " nps=" << static_cast<uint64_t>(cal.nps)
+              << " ebf=" << cal.ebf << " -> depth " << lim.start_depth << ".." << lim.max_depth
+              << " (~" << target_ms << " ms/jogada)\n";
+    return lim;
+}
+
+static void apply_game_depth(GameController& controller, int rows, int cols, int target_ms,
+                             const std::optional<int>& depthFlag, const std::optional<int>& maxDepthFlag) {
+    if (depthFlag || maxDepthFlag) {
+        const int start = depthFlag.value_or(*maxDepthFlag);
+        controller.set_depth_limits(start, maxDepthFlag.value_or(start));
+    } else if (auto lim = calibrated_depth(rows, cols, target_ms, depthFlag, maxDepthFlag)) {
+        controller.set_depth_limits(lim->start_depth, lim->max_depth);
+        controller.set_move_time(2 * target_ms);   // teto para máquinas abaixo da estimativa
+    }
+}
+
 // Executa um jogo de teste com temporização e devolve true se a AI1 venceu
 template <typename Factory>
 static bool run_ai_game(Factory&& makeController,
                         int runMode,
                         const OrderingConfig& ordCfg,
                         const QuiescenceConfig& qCfg,
+                        const MCTSSetup& mctsCfg,
+                        const SelectiveSetup& selCfg,
+                        const BudgetSetup& budgetCfg,
                         const std::optional<int>& depthFlag,
                         const std::optional<int>& maxDepthFlag,
                         const std::optional<int>& depthFlag1,
@@ -218,6 +321,9 @@ static bool run_ai_game(Factory&& makeController,
     TestController controller = makeController();
     apply_ordering(controller, ordCfg);
     apply_quiescence(controller, qCfg);
+    apply_mcts(controller, mctsCfg);
+    apply_selective(controller, selCfg);
+    apply_budget(controller, budgetCfg);
     apply_depth_overrides(controller, depthFlag, maxDepthFlag, depthFlag1, depthFlag2, maxDepthFlag1, maxDepthFlag2);
 
     bool win = controller.run(runMode);
@@ -250,6 +356,43 @@ int main(int argc, char* argv[]) {
     auto heurFlagBoth = get_flag_str(argc, argv, "-h",  "--heur");
     auto heurFlagP1   = get_flag_str(argc, argv, "-h1", "--heur1");
     auto heurFlagP2   = get_flag_str(argc, argv, "-h2", "--heur2");
+    auto qPliesFlag   = get_flag_int(argc, argv, "-q",  "--quiescence");
+    auto mcts1Flag    = get_flag_int(argc, argv, "--mcts1", "--mcts1");
+    auto mcts2Flag    = get_flag_int(argc, argv, "--mcts2", "--mcts2");
+    auto mctsThreads  = get_flag_int(argc, argv, "--mcts-threads", "--mcts-threads");
+    auto mctsMs       = get_flag_int(argc, argv, "--mcts-ms", "--mcts-ms");
+    bool mctsHeur     = false;
+    for (int i = 1; i < argc; ++i) if (std::string(argv[i]) == "--mcts-heur") mctsHeur = true;
+
+    MCTSSetup mctsCfg{};
+    mctsCfg.enableMax = mcts1Flag.has_value();
+    mctsCfg.enableMin = mcts2Flag.has_value();
+    if (mcts1Flag || mcts2Flag) {
+        mctsCfg.cfg.playouts = static_cast<uint64_t>(std::max(0, mcts1Flag ? *mcts1Flag : *mcts2Flag));
+    }
+    if (mctsThreads) mctsCfg.cfg.threads = std::max(1, *mctsThreads);
+    if (mctsMs) mctsCfg.cfg.time_ms = std::max(0, *mctsMs);
+    mctsCfg.cfg.heuristic_rollouts = mctsHeur;
+
+    SelectiveSetup selCfg{};
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--lmr") selCfg.lmr = true;
+        if (std::string(argv[i]) == "--futility") selCfg.futility = true;
+        if (std::string(argv[i]) == "--ext") selCfg.extensions = true;
+    }
+
+    BudgetSetup budgetCfg{};
+    if (auto n = get_flag_int(argc, argv, "--nodes", "--nodes")) budgetCfg.nodes = static_cast<uint64_t>(std::max(0, *n));
+    if (auto sd = get_flag_int(argc, argv, "--seed", "--seed")) budgetCfg.seed = static_cast<uint64_t>(*sd);
+    if (auto ms = get_flag_int(argc, argv, "--move-ms", "--move-ms")) budgetCfg.move_ms = std::max(0, *ms);
+    if (auto c = get_flag_int(argc, argv, "--clock", "--clock")) budgetCfg.clock.total_ms = std::max(0, *c);
+    if (auto inc = get_flag_int(argc, argv, "--inc", "--inc")) budgetCfg.clock.increment_ms = std::max(0, *inc);
+
+    // Calibração: por omissão no modo de jogo (~1 s por jogada), nos modos de
+    // teste só com --target-ms; --no-calibrate mantém as profundidades fixas
+    auto targetMsFlag = get_flag_int(argc, argv, "--target-ms", "--target-ms");
+    bool noCalibrate = false;
+    for (int i = 1; i < argc; ++i) if (std::string(argv[i]) == "--no-calibrate") noCalibrate = true;
 
     if (depthFlag && !maxDepthFlag) maxDepthFlag = depthFlag;
     if (depthFlag1 && !maxDepthFlag1) maxDepthFlag1 = depthFlag1;
@@ -324,6 +467,8 @@ int main(int argc, char* argv[]) {
             }
 
             GameController controller(mode, rows, cols);
+            apply_game_depth(controller, rows, cols, noCalibrate ? 0 : targetMsFlag.value_or(1000),
+                             depthFlag, maxDepthFlag);
             controller.run();
         } else if (board_choice == "2") {
             std::string path;
@@ -380,6 +525,8 @@ int main(int argc, char* argv[]) {
             }
 
             GameController controller(mode, rows, cols, board, move_count);
+            apply_game_depth(controller, rows, cols, noCalibrate ? 0 : targetMsFlag.value_or(1000),
+                             depthFlag, maxDepthFlag);
             controller.run();
         } else {
             std::cout << "Opção inválida.\n";
@@ -392,6 +539,12 @@ int main(int argc, char* argv[]) {
             cols = *colFlag;
         }
 
+        if (!noCalibrate && targetMsFlag) {
+            if (auto lim = calibrated_depth(rows, cols, *targetMsFlag, depthFlag, maxDepthFlag)) {
+                depthFlag = lim->start_depth;
+                maxDepthFlag = lim->max_depth;
+            }
+        }
         int AI1_victory = 0;
         int AI2_victory = 0;
 
@@ -400,6 +553,10 @@ int main(int argc, char* argv[]) {
 
         OrderingConfig ordCfg = parse_ordering_config(cargc, cargv);
         QuiescenceConfig qCfg{};
+        if (qPliesFlag && *qPliesFlag > 0) {
+            qCfg.enableMax = qCfg.enableMin = true;
+            qCfg.plies = *qPliesFlag;
+        }
         log_ordering(ordCfg);
 
         for (std::pair<int, int> move : valid_moves) {
@@ -408,6 +565,9 @@ int main(int argc, char* argv[]) {
                 /*runMode=*/1,
                 ordCfg,
                 qCfg,
+                mctsCfg,
+                selCfg,
+                budgetCfg,
                 depthFlag,
                 maxDepthFlag,
                 depthFlag1,
@@ -429,6 +589,12 @@ int main(int argc, char* argv[]) {
             cols = *colFlag;
         }
         std::cout << " - Board: " << rows << "x" << cols << "\n";
+        if (!noCalibrate && targetMsFlag) {
+            if (auto lim = calibrated_depth(rows, cols, *targetMsFlag, depthFlag, maxDepthFlag)) {
+                depthFlag = lim->start_depth;
+                maxDepthFlag = lim->max_depth;
+            }
+        }
         int AI1_victory = 0;
         int AI2_victory = 0;
 
@@ -437,17 +603,26 @@ int main(int argc, char* argv[]) {
 
         OrderingConfig ordCfg = parse_ordering_config(cargc, cargv);
         QuiescenceConfig qCfg{};
+        if (qPliesFlag && *qPliesFlag > 0) {
+            qCfg.enableMax = qCfg.enableMin = true;
+            qCfg.plies = *qPliesFlag;
+        }
         log_ordering(ordCfg);
 
         int games = gamesFlag.value_or(100); 
         
         for (int i = 1; i <= games; i++) {
             std::cout << " - Jogo: " << i << "\n";
+            BudgetSetup gameBudget = budgetCfg;   // uma semente por jogo: série reprodutível
+            if (gameBudget.seed) *gameBudget.seed += 2 * uint64_t(i - 1);
             bool win = run_ai_game(
                 [&]() { return TestController(mode, rows, cols, debug, combo_p1, combo_p2); },
                 /*runMode=*/2,
                 ordCfg,
                 qCfg,
+                mctsCfg,
+                selCfg,
+                gameBudget,
                 depthFlag,
                 maxDepthFlag,
                 depthFlag1,
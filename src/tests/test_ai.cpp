@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "AI.hpp"
 #include "Board.hpp"
+#include "MCTS.hpp"
 #include <algorithm>
 
 
@@ -146,3 +147,44 @@ INSTANTIATE_TEST_SUITE_P(
     std::make_pair(11,11)
   )
 );
+
+/* ---------------------------------
+   MCTS: mesma interface choose_move do AI
+   --------------------------------- */
+TEST(MCTSChoice, TakesImmediateWinAndAvoidsOpponentGoal) {
+  const int rows = 7, cols = 7;
+  Board win(rows, cols);
+  win.reset_board(rows, cols, /*block_initial=*/false);
+  win.set_marker_pos(rows-2, 1, /*also_block_here=*/true);
+
+  MCTSConfig cfg;
+  cfg.playouts = 4000;
+  cfg.seed = 7;
+  MCTS mcts(/*is_max=*/true, cfg);
+  EXPECT_EQ(mcts.choose_move(win, -1, 1), std::make_pair(rows-1, 0));
+
+  // Marcador a dois passos do objetivo de MIN: MAX não deve ficar ao lado dele
+  Board risky(rows, cols);
+  risky.reset_board(rows, cols, /*block_initial=*/false);
+  risky.set_marker_pos(2, cols-2, /*also_block_here=*/true);
+  auto chosen = mcts.choose_move(risky, -1, 1);
+  EXPECT_GT(cheb(chosen.first, chosen.second, 0, cols-1), 1);
+}
+
+TEST(MCTSChoice, SeededSingleThreadIsReproducibleAndThreadsRun) {
+  Board b(9, 9);
+  MCTSConfig cfg;
+  cfg.playouts = 3000;
+  cfg.seed = 42;
+  cfg.heuristic_rollouts = true;
+  MCTS a(/*is_max=*/true, cfg), c(/*is_max=*/true, cfg);
+  EXPECT_EQ(a.choose_move(b, -1, 1), c.choose_move(b, -1, 1));
+  EXPECT_EQ(a.last_playouts(), 3000u);
+
+  cfg.threads = 4;
+  MCTS par(/*is_max=*/true, cfg);
+  auto mv = par.choose_move(b, -1, 1);
+  auto valid = b.get_valid_moves();
+  EXPECT_NE(std::find(valid.begin(), valid.end(), mv), valid.end());
+  EXPECT_EQ(par.last_playouts(), 3000u);
+}
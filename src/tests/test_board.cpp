@@ -64,3 +64,52 @@ TEST(BoardReachability, ComputesBothGoalDistancesAndCount) {
   EXPECT_LT(res.h1, 0);
   EXPECT_GT(res.h5, 0);
 }
+
+TEST(BoardCorridor, ForcedLineParityAndOpenLines) {
+  Board b(7,7);
+  b.reset_board(7, 7, /*block_initial=*/false);
+  // corredor (3,3)->(3,4)->(3,5): entrar deixa a última casa ao adversário
+  for (int r = 0; r < 7; ++r)
+    for (int c = 0; c < 7; ++c)
+      if (!(r == 3 && c >= 3 && c <= 5)) b.block_cell(r, c);
+  b.set_marker_pos(3, 3, /*also_block_here=*/false);
+  EXPECT_LE(b.free_neighbours(3, 4), 2);   // entrada + saída
+  EXPECT_EQ(b.forced_line_after({3, 4}), 1);   // ímpar: quem joga perde
+
+  Board open(7,7);
+  place_marker(open, 3, 3, true);
+  EXPECT_GT(open.free_neighbours(3, 4), 2);
+  EXPECT_EQ(open.forced_line_after({3, 4}), -1);
+}
+
+TEST(BoardHash, HashAfterMatchesAppliedMove) {
+  Board b(7,7);
+  for (int ply = 0; ply < 6; ++ply) {
+    for (const auto& mv : b.get_valid_moves()) {
+      const uint64_t predicted = b.hash_after(mv);
+      auto undo = b.apply_move(mv);
+      EXPECT_EQ(predicted, b.get_hash());
+      b.undo_move(undo);
+    }
+    b.apply_move(b.get_valid_moves().back());
+  }
+}
+
+TEST(BoardMoveList, PackedListMatchesValidMoves) {
+  Board b(7,7);
+  place_marker(b, 3, 3, true);
+  b.block_cell(2, 3);
+  const auto list = b.valid_move_list();
+  const auto moves = b.get_valid_moves();
+  ASSERT_EQ(list.size(), static_cast<int>(moves.size()));
+  EXPECT_GE(list.size(), 1);
+  const auto decoded = list.decode(b.get_marker());
+  for (int i = 0; i < list.size(); ++i) {
+    EXPECT_EQ(decoded[i], moves[i]);
+    EXPECT_EQ(PackedMove::between(b.get_marker(), moves[i]), list[i]);
+  }
+  EXPECT_LT(list.raw(), 1u << 28);   // 4 bits de contagem + 8 x 3 bits
+
+  place_marker(b, 0, 0, true);   // canto: 3 vizinhos
+  EXPECT_EQ(b.valid_move_list().size(), 3);
+}
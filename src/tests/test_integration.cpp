@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "AI.hpp"
 #include "Board.hpp"
+#include "GameController.hpp"
 #include <algorithm>
 #include <cmath>
 #include <utility>
@@ -8,6 +9,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <thread>
 
 // Simple 64-bit FNV-1a rolling hash for move sequences
 static uint64_t hash_moves(uint64_t h, int r, int c) {
@@ -275,3 +277,39 @@ INSTANTIATE_TEST_SUITE_P(
     std::make_pair(11,11)
   )
 );
+
+// Pondering: depois da jogada da IA, as respostas do humano são procuradas em
+// segundo plano; uma resposta já procurada conta como ponder hit e uma
+// resposta dada de imediato termina (hit em curso) ou interrompe a procura.
+TEST(IntegrationPondering, HumanReplyResolvesPonderThread) {
+  {
+    GameController gc("ai_first", 6, 6);
+    gc.run_ai_turn();                                   // IA (MAX) joga e começa a ponderar
+    // espera que todas as respostas estejam procuradas (com limite)
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (!gc.pondering_done() && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_TRUE(gc.pondering_done());
+    auto replies = gc.get_valid_moves();
+    ASSERT_FALSE(replies.empty());
+    gc.make_move(replies.back().first, replies.back().second);
+    EXPECT_EQ(gc.get_ponder_hits(), 1);
+    EXPECT_EQ(gc.get_ponder_misses(), 0);
+  }
+  {
+    GameController gc("ai_first", 6, 6);
+    gc.run_ai_turn();
+    auto replies = gc.get_valid_moves();
+    ASSERT_FALSE(replies.empty());
+    gc.make_move(replies.back().first, replies.back().second);   // sem esperar
+    EXPECT_EQ(gc.get_ponder_hits() + gc.get_ponder_misses(), 1);
+  }
+  {
+    GameController gc("ai_first", 6, 6);
+    gc.set_pondering(false);
+    gc.run_ai_turn();
+    auto replies = gc.get_valid_moves();
+    gc.make_move(replies.front().first, replies.front().second);
+    EXPECT_EQ(gc.get_ponder_hits() + gc.get_ponder_misses(), 0);
+  }
+}
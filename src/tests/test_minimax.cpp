@@ -1,7 +1,17 @@
 #include <gtest/gtest.h>
 #include "AI.hpp"
 #include "Board.hpp"
+#include "ResumableSearch.hpp"
+#include "TimeManager.hpp"
+#include "Calibration.hpp"
+#include "SearchArena.hpp"
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -163,3 +173,835 @@ TEST(Minimax, Takes_WinInTwo_IfExists_Depth2) {
 }
 
 
+
+// Com quiescence ativa, mesmo a profundidade 0 deve ver a vitória imediata
+// de MIN para lá do horizonte e evitar os lances que a permitem.
+TEST(Minimax, Quiescence_Avoids_OpponentImmediateWin_Depth0) {
+  const int rows = 7, cols = 7;
+  Board b(rows, cols);
+  b.reset_board(rows, cols, /*block_initial=*/false);
+  b.set_marker_pos(2, cols - 2, /*also_block_here=*/true);
+
+  auto bad = dangerous_for_max(b);
+  ASSERT_FALSE(bad.empty());
+
+  AI ai(/*is_max=*/true, /*max_depth=*/0);
+  ai.set_quiescence(true, /*max_plies=*/4);
+  auto chosen = ai.choose_move(b, /*depth_override=*/0, /*rounds=*/5);
+
+  auto valids = b.get_valid_moves();
+  EXPECT_TRUE(std::find(valids.begin(), valids.end(), chosen) != valids.end());
+  EXPECT_TRUE(std::find(bad.begin(), bad.end(), chosen) == bad.end())
+      << "Quiescence at depth 0 selected a move that lets MIN win immediately.";
+}
+
+// Se todas as jogadas de um nó de quiescence ficam junto ao objetivo livre
+// do adversário, o nó é uma derrota (e não o stand-pat). Aqui (5,2) deixa
+// MIN só com (5,1)/(6,1), ambas vizinhas do objetivo de MAX.
+TEST(Minimax, Quiescence_AllMovesNextToOpponentGoal_IsLoss_Depth0) {
+  Board b(7, 7);
+  b.reset_board(7, 7, /*block_initial=*/false);
+  b.set_marker_pos(4, 2, /*also_block_here=*/true);
+  for (const Board::Move& c : std::vector<Board::Move>{{4, 1}, {4, 3}, {5, 3}, {6, 2}, {6, 3}}) {
+    b.block_cell(c.first, c.second);
+  }
+
+  AI q(/*is_max=*/true, /*max_depth=*/0);
+  q.set_quiescence(true, /*max_plies=*/4);
+  EXPECT_EQ(q.choose_move(b, /*depth_override=*/0, /*rounds=*/5), Board::Move(5, 2));
+
+  AI full(/*is_max=*/true, /*max_depth=*/6);
+  full.choose_move(b, /*depth_override=*/6, /*rounds=*/5);
+  EXPECT_EQ(q.last_score(), full.last_score());
+}
+
+TEST(Minimax, GoalThreats_PruneMovesNextToOpponentGoal_Depth3) {
+  const int rows = 7, cols = 7;
+  Board b(rows, cols);
+  b.reset_board(rows, cols, /*block_initial=*/false);
+  b.set_marker_pos(2, cols - 2, /*also_block_here=*/true);
+
+  auto bad = dangerous_for_max(b);
+  ASSERT_FALSE(bad.empty());
+
+  AI ai(/*is_max=*/true, /*max_depth=*/3);
+  auto chosen = ai.choose_move(b, /*depth_override=*/3, /*rounds=*/5);
+
+  EXPECT_TRUE(std::find(bad.begin(), bad.end(), chosen) == bad.end());
+  // MIN entra diretamente no objetivo; MAX nem desce às jogadas que o permitem
+  EXPECT_GT(ai.ordering_stats(/*is_max_node=*/false).immediate_wins, 0u);
+  EXPECT_GT(ai.ordering_stats(/*is_max_node=*/true).threat_prunes, 0u);
+}
+
+// Região isolada (objetivos inalcançáveis): o RegionSolver resolve de forma
+// exata "quem fica sem jogadas primeiro" num corredor a partir de (3,3).
+static Board isolated_corridor(int length) {
+  Board b(7, 7);
+  b.reset_board(7, 7, /*block_initial=*/false);
+  for (int r = 0; r < 7; ++r)
+    for (int c = 0; c < 7; ++c)
+      if (!(r == 3 && c >= 3 && c <= 3 + length)) b.block_cell(r, c);
+  b.set_marker_pos(3, 3, /*also_block_here=*/true);
+  return b;
+}
+
+TEST(RegionSolver, CorridorParityDecidesWinner) {
+  RegionSolver solver;
+  // 2 casas: quem joga entra, o adversário ocupa a última -> quem joga perde
+  Board even = isolated_corridor(2);
+  auto reach = even.compute_distance();
+  ASSERT_EQ(reach.h1, -900);
+  ASSERT_EQ(reach.h5, 900);
+  EXPECT_EQ(solver.solve(even), RegionSolver::Outcome::Loss);
+
+  // 3 casas: quem joga fica com a última -> quem joga ganha
+  Board odd = isolated_corridor(3);
+  EXPECT_EQ(solver.solve(odd), RegionSolver::Outcome::Win);
+}
+
+// Região que esgota o orçamento: o teto de células desce e a mesma região
+// (ou outra do mesmo tamanho) já não volta a correr o DFS; as pequenas sim.
+TEST(RegionSolver, ExhaustedRegionLowersCellLimit) {
+  Board open(7, 7);
+  open.reset_board(7, 7, /*block_initial=*/false);
+  for (int r = 0; r < 7; ++r)
+    for (int c = 0; c < 7; ++c)
+      if (r < 1 || r > 5 || c < 1 || c > 5) open.block_cell(r, c);
+  open.set_marker_pos(3, 3, /*also_block_here=*/true);   // 24 casas livres em volta
+
+  RegionSolver solver(/*max_cells=*/64, /*node_budget=*/50);
+  EXPECT_EQ(solver.solve(open), RegionSolver::Outcome::Unknown);
+  EXPECT_GT(solver.last_nodes(), 50u);
+  EXPECT_EQ(solver.cell_limit(), 23);
+
+  EXPECT_EQ(solver.solve(open), RegionSolver::Outcome::Unknown);
+  EXPECT_EQ(solver.last_nodes(), 0u);
+  EXPECT_EQ(solver.solve(isolated_corridor(3)), RegionSolver::Outcome::Win);
+
+  solver.clear();
+  EXPECT_EQ(solver.cell_limit(), 64);
+}
+
+TEST(RegionSolver, MinimaxPicksWinningCorridor) {
+  // (3,3) com dois corredores isolados: esquerda com 3 casas (ganha),
+  // direita com 2 casas (perde)
+  Board b(7, 7);
+  b.reset_board(7, 7, /*block_initial=*/false);
+  for (int r = 0; r < 7; ++r)
+    for (int c = 0; c < 7; ++c)
+      if (!(r == 3 && c <= 5)) b.block_cell(r, c);
+  b.set_marker_pos(3, 3, /*also_block_here=*/true);
+
+  AI ai(/*is_max=*/true, /*max_depth=*/2);
+  auto chosen = ai.choose_move(b, /*depth_override=*/2, /*rounds=*/5);
+  EXPECT_EQ(chosen, std::make_pair(3, 2));
+}
+
+TEST(CorridorMacros, DeadEndResolvedBeyondHorizon) {
+  // Mesmo tabuleiro de corredores, mas a profundidade 1 e sem RegionSolver:
+  // as duas jogadas da raiz são resolvidas pela leitura das linhas forçadas.
+  Board b(7, 7);
+  b.reset_board(7, 7, /*block_initial=*/false);
+  for (int r = 0; r < 7; ++r)
+    for (int c = 0; c < 7; ++c)
+      if (!(r == 3 && c >= 1)) b.block_cell(r, c);
+  b.set_marker_pos(3, 3, /*also_block_here=*/true);
+
+  AI ai(/*is_max=*/true, /*max_depth=*/1);
+  ai.set_region_solver(false);
+  auto chosen = ai.choose_move(b, /*depth_override=*/1, /*rounds=*/5);
+  EXPECT_EQ(chosen, std::make_pair(3, 4));
+  EXPECT_EQ(ai.ordering_stats(/*is_max_node=*/true).dead_ends, 2u);
+}
+
+// Proof-number search: veredicto exato com jogada de prova
+TEST(ProofNumber, SolvesCorridorParityWithProofMove) {
+  Board b(7, 7);
+  b.reset_board(7, 7, /*block_initial=*/false);
+  for (int r = 0; r < 7; ++r)
+    for (int c = 0; c < 7; ++c)
+      if (!(r == 3 && c >= 1)) b.block_cell(r, c);
+  b.set_marker_pos(3, 3, /*also_block_here=*/true);
+
+  AI ai(/*is_max=*/true, /*max_depth=*/1);
+  auto v = ai.solve(b, /*node_budget=*/10000);
+  EXPECT_EQ(v.result, ProofNumberSolver::Result::Win);
+  EXPECT_EQ(v.move, std::make_pair(3, 4));
+
+  // depois da jogada de prova, o adversário está perdido
+  Board after = b;
+  after.apply_move(v.move);
+  EXPECT_EQ(ai.solve(after, 10000).result, ProofNumberSolver::Result::Loss);
+}
+
+TEST(ProofNumber, GoalInOneAndBudgetExhaustion) {
+  Board b(7, 7);
+  b.reset_board(7, 7, /*block_initial=*/false);
+  b.set_marker_pos(5, 1, /*also_block_here=*/true);   // MAX a jogar, ao lado do objetivo
+  AI ai(/*is_max=*/true, /*max_depth=*/1);
+  auto v = ai.solve(b, 100);
+  EXPECT_EQ(v.result, ProofNumberSolver::Result::Win);
+  EXPECT_EQ(v.move, std::make_pair(6, 0));
+
+  Board open(7, 7);   // posição inicial: impossível de provar com 50 nós
+  EXPECT_EQ(ai.solve(open, 50).result, ProofNumberSolver::Result::Unknown);
+}
+
+// BD de jogo perfeito: gerada para 4x5 numa pasta temporária e consultada
+// pelo choose_move antes da procura (e antes da 1ª jogada aleatória) quando
+// ligada; uma BD criada depois da 1ª consulta só aparece após rescan_missing().
+TEST(PerfectPlayDB, BuildProbeAndChooseMove) {
+  const std::string dir = ::testing::TempDir() + "/pdb";
+  std::filesystem::create_directories(dir);
+  const char* prev = std::getenv("RASTROS_DATA_DIR");
+  const std::string saved = prev ? prev : "";
+  ASSERT_EQ(setenv("RASTROS_DATA_DIR", dir.c_str(), 1), 0);
+  const std::string path = PerfectPlayDB::default_path(4, 5);
+  std::filesystem::remove(path);
+  EXPECT_EQ(PerfectPlayDB::for_size(4, 5), nullptr);
+  ASSERT_GT(PerfectPlayDB::build(4, 5, path), 0u);
+  EXPECT_EQ(PerfectPlayDB::for_size(4, 5), nullptr);
+  PerfectPlayDB::rescan_missing();
+  EXPECT_NE(PerfectPlayDB::for_size(4, 5), nullptr);
+
+  PerfectPlayDB db;
+  ASSERT_TRUE(db.open(path));
+  Board start(4, 5);
+  ProofNumberSolver pns;
+  auto exact = pns.solve(start, 1000000).result;
+  ASSERT_NE(exact, ProofNumberSolver::Result::Unknown);
+  EXPECT_EQ(db.probe(start, true) == PerfectPlayDB::Result::Win,
+            exact == ProofNumberSolver::Result::Win);
+
+  if (exact == ProofNumberSolver::Result::Win) {
+    AI ai(/*is_max=*/true, /*max_depth=*/1);
+    ai.set_perfect_db(true);
+    auto mv = ai.choose_move(start, /*depth_override=*/1, /*rounds=*/0);
+    Board after = start;
+    after.apply_move(mv);
+    EXPECT_EQ(pns.solve(after, 1000000).result, ProofNumberSolver::Result::Loss);
+  }
+
+  std::filesystem::remove(path);
+  if (prev) setenv("RASTROS_DATA_DIR", saved.c_str(), 1);
+  else      unsetenv("RASTROS_DATA_DIR");
+}
+
+// Livro de aberturas: gerado para 5x6 (2 plies, profundidade 3) e consultado
+// pelo choose_move sem procura; a posição rodada 180° (objetivos e lado
+// trocados) encontra a mesma entrada com a jogada transformada.
+TEST(OpeningBook, BuildLookupSymmetryAndChooseMove) {
+  const std::string dir = ::testing::TempDir() + "/book";
+  std::filesystem::create_directories(dir);
+  const char* prev = std::getenv("RASTROS_DATA_DIR");
+  const std::string saved = prev ? prev : "";
+  ASSERT_EQ(setenv("RASTROS_DATA_DIR", dir.c_str(), 1), 0);
+  const std::string path = OpeningBook::default_path(5, 6);
+  std::filesystem::remove(path);
+  OpeningBook::rescan_missing();
+  uint64_t enumerated = 0;
+  const uint64_t n = OpeningBook::build(5, 6, /*plies=*/2, /*depth=*/3, /*threads=*/2, path, &enumerated);
+  ASSERT_GT(n, 0u);
+  EXPECT_GE(enumerated, n);
+
+  OpeningBook book;
+  ASSERT_TRUE(book.open(path));
+  EXPECT_EQ(book.get_depth(), 3);
+
+  Board pos(5, 6);
+  pos.apply_move(pos.get_valid_moves().front());   // MIN a jogar, ply 1
+  OpeningBook::Hit hit;
+  ASSERT_TRUE(book.lookup(pos, /*mover_max=*/false, hit));
+
+  // Rotação 180°: mesmas casas bloqueadas rodadas, MAX a jogar
+  Board rot(5, 6, /*skip_initial_marker=*/true);
+  const auto& g = pos.grid_ref();
+  for (int r = 0; r < 5; ++r)
+    for (int c = 0; c < 6; ++c)
+      if (g[r][c] == 0) rot.block_cell(4 - r, 5 - c);
+  const auto mk = pos.get_marker();
+  rot.set_marker_pos(4 - mk.first, 5 - mk.second);
+  rot.set_current_player_from_int(1);
+  OpeningBook::Hit hit_rot;
+  ASSERT_TRUE(book.lookup(rot, /*mover_max=*/true, hit_rot));
+  EXPECT_EQ(hit_rot.move, OpeningBook::map_move(hit.move, 3, 5, 6));
+  EXPECT_EQ(hit_rot.score, hit.score);
+
+  // choose_move (livro ligado): jogada do livro sem procura; profundidade acima
+  // da do livro procura; com o livro desligado (omissão) procura sempre
+  AI ai(/*is_max=*/false, /*max_depth=*/3);
+  ai.set_opening_book(true);
+  EXPECT_EQ(ai.choose_move(pos, /*depth_override=*/3, /*rounds=*/1), hit.move);
+  EXPECT_EQ(ai.get_eval_successors(), 0);
+  EXPECT_EQ(ai.last_score(), -hit.score);
+  ai.choose_move(pos, /*depth_override=*/5, /*rounds=*/1);
+  EXPECT_GT(ai.get_eval_successors(), 0);
+  AI off(/*is_max=*/false, /*max_depth=*/3);
+  off.choose_move(pos, /*depth_override=*/3, /*rounds=*/1);
+  EXPECT_GT(off.get_eval_successors(), 0);
+
+  std::filesystem::remove(path);
+  if (prev) setenv("RASTROS_DATA_DIR", saved.c_str(), 1);
+  else      unsetenv("RASTROS_DATA_DIR");
+}
+
+// Paragem cooperativa: com paragem pedida a procura termina de imediato,
+// marca-se como interrompida e não grava na TT; depois de clear_stop volta ao normal.
+TEST(SearchStop, RequestStopAbortsWithoutPollutingTT) {
+  Board b(7, 7);
+  b.apply_move(b.get_valid_moves().front());
+  const bool is_max = b.current_player_is_max();
+
+  AI ai(is_max, /*max_depth=*/5);
+  ai.request_stop();
+  auto mv = ai.choose_move(b, /*depth_override=*/5, /*rounds=*/1);
+  EXPECT_TRUE(ai.search_aborted());
+  auto valid = b.get_valid_moves();
+  EXPECT_NE(std::find(valid.begin(), valid.end(), mv), valid.end());
+  const uint64_t inserts_after_abort = ai.search_context().vs_inserts;
+
+  ai.clear_stop();
+  AI ref(is_max, /*max_depth=*/5);
+  auto expected = ref.choose_move(b, /*depth_override=*/5, /*rounds=*/1);
+  EXPECT_EQ(inserts_after_abort, 0u);
+  EXPECT_EQ(ai.choose_move(b, /*depth_override=*/5, /*rounds=*/1), expected);
+  EXPECT_FALSE(ai.search_aborted());
+}
+
+// LMR: com reduções a mesma procura visita menos nós; com uma tabela que não
+// reduz nenhum filho (full_moves = 8) o resultado é idêntico ao da procura sem LMR.
+TEST(LateMoveReductions, ReducesNodesAndHonoursPerSizeTable) {
+  Board b(7, 7);
+  b.apply_move(b.get_valid_moves().front());
+  const bool is_max = b.current_player_is_max();
+
+  AI plain(is_max, 7);
+  auto mv_plain = plain.choose_move(b, /*depth_override=*/7, /*rounds=*/1);
+
+  AI lmr(is_max, 7);
+  lmr.set_lmr(true);
+  auto mv_lmr = lmr.choose_move(b, /*depth_override=*/7, /*rounds=*/1);
+  auto valid = b.get_valid_moves();
+  EXPECT_NE(std::find(valid.begin(), valid.end(), mv_lmr), valid.end());
+  const uint64_t reductions = lmr.ordering_stats(true).lmr_reductions + lmr.ordering_stats(false).lmr_reductions;
+  EXPECT_GT(reductions, 0u);
+  EXPECT_LT(lmr.get_eval_successors(), plain.get_eval_successors());
+
+  AI off_table(is_max, 7);
+  off_table.set_lmr(true);
+  LMRParams none = LMRParams::for_board(7, 7);
+  none.full_moves = 8;
+  off_table.set_lmr_params(7, 7, none);
+  EXPECT_EQ(off_table.choose_move(b, /*depth_override=*/7, /*rounds=*/1), mv_plain);
+  EXPECT_EQ(off_table.ordering_stats(true).lmr_reductions + off_table.ordering_stats(false).lmr_reductions, 0u);
+  EXPECT_EQ(off_table.get_eval_successors(), plain.get_eval_successors());
+}
+
+// Futilidade/razoring: com as margens por omissão há cortes e menos nós; com
+// margens enormes nunca disparam e a procura é idêntica à normal.
+TEST(FutilityPruning, MarginsControlFrontierCuts) {
+  Board b(7, 7);
+  b.apply_move(b.get_valid_moves().front());
+  const bool is_max = b.current_player_is_max();
+
+  AI plain(is_max, 7);
+  auto mv_plain = plain.choose_move(b, /*depth_override=*/7, /*rounds=*/1);
+
+  AI fut(is_max, 7);
+  fut.set_futility(true);
+  auto mv_fut = fut.choose_move(b, /*depth_override=*/7, /*rounds=*/1);
+  auto valid = b.get_valid_moves();
+  EXPECT_NE(std::find(valid.begin(), valid.end(), mv_fut), valid.end());
+  uint64_t cuts = 0;
+  for (bool side : {true, false}) {
+    cuts += fut.ordering_stats(side).futility_prunes + fut.ordering_stats(side).razor_prunes;
+  }
+  EXPECT_GT(cuts, 0u);
+  EXPECT_LT(fut.get_eval_successors(), plain.get_eval_successors());
+
+  AI wide(is_max, 7);
+  wide.set_futility(true, FutilityParams{10000, 10000});
+  EXPECT_EQ(wide.choose_move(b, /*depth_override=*/7, /*rounds=*/1), mv_plain);
+  EXPECT_EQ(wide.get_eval_successors(), plain.get_eval_successors());
+}
+
+// Bloqueio na fronteira: MIN a jogar está perdido, e a vitória de MAX passa
+// por uma jogada que deixa MIN sem saída num nó dentro da janela de
+// futilidade. A célula do marcador (ainda livre) não pode contar como saída.
+TEST(FutilityPruning, StalematingMoveIsNeverCut) {
+  Board b(6, 6);
+  for (const Board::Move& m : std::vector<Board::Move>{
+           {1, 2}, {1, 1}, {2, 0}, {1, 0}, {0, 0}, {0, 1}, {0, 2}, {1, 3}, {0, 4}, {1, 5}, {2, 5}}) {
+    b.apply_move(m);
+  }
+  ASSERT_FALSE(b.current_player_is_max());
+
+  AI plain(false, 4);
+  plain.choose_move(b, /*depth_override=*/4, /*rounds=*/3);
+  ASSERT_GT(plain.last_score(), 500);   // derrota forçada de MIN
+
+  AI fut(false, 4);
+  fut.set_futility(true);
+  fut.choose_move(b, /*depth_override=*/4, /*rounds=*/3);
+  EXPECT_EQ(fut.last_score(), plain.last_score());
+}
+
+TEST(RaceBounds, GoalAndStalemateBoundsAreSoundCutoffs) {
+  // 7x7 livre com o marcador no canto (0,0): objetivos a 6 plies; o bloqueio
+  // mais cedo é em (0,1) (4 vizinhos livres -> ply 5, de quem joga)
+  Board open(7, 7, /*skip_initial_marker=*/true);
+  open.set_marker_pos(0, 0, /*also_block_here=*/true);
+  const auto rb = RaceBounds::compute(open, /*max_to_move=*/true);
+  EXPECT_EQ(rb.max_win_ply, 5);
+  EXPECT_EQ(rb.min_win_ply, 6);
+  EXPECT_EQ(rb.upper(/*depth=*/3), 1000 - 7);
+  EXPECT_EQ(rb.lower(/*depth=*/40), -RaceBounds::kHeuristicBound);
+
+  // Mesmo score e jogada com e sem os cortes (região sem solver: valores iguais)
+  Board b(5, 5);
+  uint64_t cuts = 0;
+  for (int ply = 0; ply < 8 && !b.is_terminal(); ++ply) {
+    const bool is_max = b.current_player_is_max();
+    AI with(is_max, 9), without(is_max, 9);
+    for (AI* ai : {&with, &without}) ai->set_region_solver(false);
+    without.set_race_bounds(false);
+    const auto mv = with.choose_move(b, /*depth_override=*/9, /*rounds=*/ply + 2);
+    EXPECT_EQ(mv, without.choose_move(b, /*depth_override=*/9, /*rounds=*/ply + 2));
+    EXPECT_EQ(with.last_score(), without.last_score());
+    EXPECT_LE(with.get_eval_successors(), without.get_eval_successors());
+    cuts += with.ordering_stats(true).race_cutoffs + with.ordering_stats(false).race_cutoffs;
+    const auto valid = b.get_valid_moves();
+    b.apply_move(valid[(ply * 7 + 3) % valid.size()]);
+  }
+  EXPECT_GT(cuts, 0u);
+}
+
+TEST(EnhancedTranspositionCutoffs, ChildTTBoundsCutWithoutChangingResult) {
+  Board b(6, 6);
+  uint64_t cuts = 0;
+  for (int ply = 0; ply < 6 && !b.is_terminal(); ++ply) {
+    const bool is_max = b.current_player_is_max();
+    AI with(is_max, 8), without(is_max, 8);
+    without.set_etc(false);
+    const auto mv = with.choose_move(b, /*depth_override=*/8, /*rounds=*/ply + 2);
+    EXPECT_EQ(mv, without.choose_move(b, /*depth_override=*/8, /*rounds=*/ply + 2));
+    EXPECT_EQ(with.last_score(), without.last_score());
+    EXPECT_LE(with.get_eval_successors(), without.get_eval_successors());
+    cuts += with.ordering_stats(true).etc_cutoffs + with.ordering_stats(false).etc_cutoffs;
+    const auto valid = b.get_valid_moves();
+    b.apply_move(valid[(ply * 5 + 1) % valid.size()]);
+  }
+  EXPECT_GT(cuts, 0u);
+}
+
+TEST(InternalIterativeDeepening, ReducedSearchSeedsOrderingWithoutChangingResult) {
+  Board b(6, 6);
+  b.apply_move(b.get_valid_moves().front());
+  b.apply_move(b.get_valid_moves().back());
+  const bool is_max = b.current_player_is_max();
+
+  AI plain(is_max, 8);
+  plain.set_iid(false);
+  auto mv_plain = plain.choose_move(b, /*depth_override=*/8, /*rounds=*/2);
+  EXPECT_EQ(plain.ordering_stats(true).iid_searches + plain.ordering_stats(false).iid_searches, 0u);
+
+  AI iid(is_max, 8);
+  iid.set_iid(true, /*min_remaining=*/4, /*reduction=*/2);
+  EXPECT_EQ(iid.choose_move(b, /*depth_override=*/8, /*rounds=*/2), mv_plain);
+  EXPECT_EQ(iid.last_score(), plain.last_score());
+  uint64_t searches = 0, best = 0;
+  for (bool side : {true, false}) {
+    searches += iid.ordering_stats(side).iid_searches;
+    best += iid.ordering_stats(side).iid_move_best;
+  }
+  EXPECT_GT(searches, 0u);
+  EXPECT_GT(best, 0u);
+  EXPECT_LE(best, searches);
+}
+
+TEST(WinLossMode, AgreesWithProofNumberSolverAndBudget) {
+  Board b(5, 5);
+  for (int ply = 0; ply < 10 && !b.is_terminal(); ++ply) {
+    AI ai(b.current_player_is_max(), /*max_depth=*/1);
+    const auto wl = ai.solve_wl(b);
+    const auto pn = ai.solve(b, /*node_budget=*/1000000);
+    ASSERT_NE(pn.result, ProofNumberSolver::Result::Unknown);
+    EXPECT_EQ(wl.result, pn.result);
+    if (wl.result == ProofNumberSolver::Result::Win) {
+      Board after = b;
+      after.apply_move(wl.move);
+      EXPECT_TRUE(after.is_terminal() || ai.solve(after, 1000000).result == ProofNumberSolver::Result::Loss);
+    }
+    const auto valid = b.get_valid_moves();
+    b.apply_move(valid[(ply * 3 + 2) % valid.size()]);
+  }
+
+  AI ai(/*is_max=*/true, /*max_depth=*/1);
+  EXPECT_EQ(ai.solve_wl(Board(7, 7), /*node_budget=*/50).result, ProofNumberSolver::Result::Unknown);
+}
+
+TEST(NodeBudget, DeterministicMoveFromDeepestCompletedIteration) {
+  Board b(7, 7);
+  for (const auto& mv : {Board::Move{2, 4}, Board::Move{3, 5}, Board::Move{4, 4}})
+    b.apply_move(mv);
+  const bool is_max = b.current_player_is_max();
+  constexpr uint64_t kBudget = 20000;
+
+  auto run = [&](uint64_t& nodes, int& depth) {
+    AI ai(is_max, 12);
+    ai.set_node_budget(kBudget);
+    ai.set_seed(42);
+    Board copy = b;
+    auto mv = ai.choose_move(copy, /*depth_override=*/12, /*rounds=*/2);
+    nodes = ai.last_search_nodes();
+    depth = ai.last_completed_depth();
+    EXPECT_FALSE(ai.search_aborted());
+    return mv;
+  };
+
+  uint64_t n1 = 0, n2 = 0;
+  int d1 = 0, d2 = 0;
+  const auto m1 = run(n1, d1);
+  const auto m2 = run(n2, d2);
+  EXPECT_EQ(m1, m2);
+  EXPECT_EQ(n1, n2);
+  EXPECT_EQ(d1, d2);
+  EXPECT_GT(d1, 0);
+  EXPECT_LT(d1, 12);
+  EXPECT_GE(n1, kBudget);
+  EXPECT_LE(n1, kBudget + 2000);   // só a quiescence em curso ultrapassa o limite
+
+  const auto valid = b.get_valid_moves();
+  EXPECT_NE(std::find(valid.begin(), valid.end(), m1), valid.end());
+}
+
+TEST(MultiPV, TopKMatchesFullRootEnumerationWithPV) {
+  Board b(7, 7);
+  for (const auto& mv : {Board::Move{2, 4}, Board::Move{3, 5}, Board::Move{4, 4}})
+    b.apply_move(mv);
+  const bool is_max = b.current_player_is_max();
+
+  AI ref(is_max, 6);
+  Board copy = b;
+  ref.choose_move(copy, /*depth_override=*/6, /*rounds=*/3);
+
+  AI ai(is_max, 6);
+  const auto top = ai.analyse(b, 3, AnalysisLimits{6, 0});
+  AI all_ai(is_max, 6);
+  const auto all = all_ai.analyse(b, 64, AnalysisLimits{6, 0});
+
+  ASSERT_EQ(top.size(), 3u);
+  EXPECT_EQ(all.size(), b.get_valid_moves().size());
+  EXPECT_EQ(top.front().score, ref.last_score());
+  for (size_t i = 0; i < top.size(); ++i) {
+    EXPECT_EQ(top[i].score, all[i].score);   // janela estreitada: os mesmos k valores exatos
+    EXPECT_EQ(top[i].depth, 6);
+    EXPECT_GT(top[i].nodes, 0u);
+    ASSERT_FALSE(top[i].pv.empty());
+    EXPECT_EQ(top[i].pv.front(), top[i].move);
+    if (i > 0) {
+      EXPECT_TRUE(is_max ? top[i - 1].score >= top[i].score : top[i - 1].score <= top[i].score);
+    }
+
+    // a PV é uma sequência legal a partir da raiz
+    Board line = b;
+    for (const auto& mv : top[i].pv) {
+      ASSERT_FALSE(line.is_terminal());
+      const auto valid = line.get_valid_moves();
+      ASSERT_NE(std::find(valid.begin(), valid.end(), mv), valid.end());
+      line.apply_move(mv);
+    }
+  }
+}
+
+TEST(ResumableSearch, SlicedSearchMatchesMinimaxAndScheduler) {
+  Board b(7, 7);
+  for (const auto& mv : {Board::Move{2, 4}, Board::Move{3, 5}, Board::Move{4, 4}, Board::Move{4, 3}})
+    b.apply_move(mv);
+  const bool is_max = b.current_player_is_max();
+
+  // referência: minimax sem os extras que a procura retomável não tem
+  AI ref(is_max, 5);
+  ref.set_region_solver(false);
+  ref.set_corridor_macros(false);
+  ref.set_race_bounds(false);
+  ref.set_etc(false);
+  ref.set_iid(false);
+  Board copy = b;
+  ref.choose_move(copy, /*depth_override=*/5, /*rounds=*/3);
+
+  AI proto(is_max, 5);
+  ResumableSearch whole(proto, b, 5);
+  EXPECT_TRUE(whole.step(0));
+  EXPECT_EQ(whole.completed_depth(), 5);
+  EXPECT_EQ(whole.best_score(), ref.last_score());
+
+  // um nó por fatia: o estado sobrevive entre chamadas e o resultado é o mesmo
+  ResumableSearch sliced(proto, b, 5);
+  int slices = 0;
+  while (!sliced.step(1)) ++slices;
+  EXPECT_GT(slices, 100);
+  EXPECT_EQ(sliced.nodes(), whole.nodes());
+  EXPECT_EQ(sliced.best_move(), whole.best_move());
+  EXPECT_EQ(sliced.best_score(), whole.best_score());
+  EXPECT_EQ(b.get_marker(), Board::Move(4, 3));   // o tabuleiro do chamador não é tocado
+
+  SearchScheduler sched(/*slice_nodes=*/37);
+  const int a = sched.add(std::make_unique<ResumableSearch>(proto, b, 5));
+  const Board small(5, 5);
+  const int c = sched.add(std::make_unique<ResumableSearch>(AI(small.current_player_is_max(), 3), small, 3));
+  EXPECT_EQ(sched.active(), 2);
+  while (sched.run_round() > 0) {}
+  EXPECT_EQ(sched.active(), 0);
+  EXPECT_EQ(sched.get(a)->best_move(), whole.best_move());
+  EXPECT_EQ(sched.get(a)->nodes(), whole.nodes());
+  EXPECT_GE(sched.get(c)->completed_depth(), 1);   // pára antes de 3 se provar o resultado
+  const auto small_moves = small.get_valid_moves();
+  EXPECT_NE(std::find(small_moves.begin(), small_moves.end(), sched.get(c)->best_move()), small_moves.end());
+  sched.remove(c);
+  EXPECT_EQ(sched.get(c), nullptr);
+}
+
+TEST(AsyncSearch, ProgressStopAndTimeLimit) {
+  Board b(7, 7);
+  for (const auto& mv : {Board::Move{2, 4}, Board::Move{3, 5}, Board::Move{4, 4}})
+    b.apply_move(mv);
+  const bool is_max = b.current_player_is_max();
+
+  AI ref(is_max, 6);
+  Board copy = b;
+  ref.choose_move(copy, /*depth_override=*/6, /*rounds=*/3);
+
+  AI ai(is_max, 6);
+  std::vector<SearchProgress> seen;
+  auto h = ai.start_search(b, SearchLimits{6, 0, 0, 3},
+                           [&](const SearchProgress& p) { seen.push_back(p); });
+  const SearchResult r = h.wait();
+  ASSERT_EQ(seen.size(), 6u);
+  for (size_t i = 0; i < seen.size(); ++i) {
+    EXPECT_EQ(seen[i].depth, static_cast<int>(i) + 1);
+    ASSERT_FALSE(seen[i].pv.empty());
+    EXPECT_EQ(seen[i].pv.front(), seen[i].best_move);
+  }
+  EXPECT_EQ(r.move, seen.back().best_move);
+  EXPECT_EQ(r.score, ref.last_score());
+  EXPECT_EQ(r.depth, 6);
+  EXPECT_FALSE(r.stopped);
+  EXPECT_EQ(h.last_progress().depth, 6);
+
+  // stop(): fica a última iteração completa; a procura seguinte não herda o pedido
+  Board big(9, 9);
+  AI deep(big.current_player_is_max(), 40);
+  auto h2 = deep.start_search(big, SearchLimits{40, 0, 0, 3});
+  while (h2.last_progress().depth < 2) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  h2.stop();
+  const SearchResult r2 = h2.wait();
+  EXPECT_TRUE(r2.stopped);
+  EXPECT_GE(r2.depth, 2);
+  EXPECT_LT(r2.depth, 40);
+  EXPECT_EQ(deep.start_search(b, SearchLimits{2, 0, 0, 3}).wait().depth, 2);
+
+  // mover um handle em curso (make_shared nos bindings) não pára a procura
+  {
+    auto moved = std::make_shared<SearchHandle>(deep.start_search(b, SearchLimits{6, 0, 0, 3}));
+    const SearchResult rm = moved->wait();
+    EXPECT_EQ(rm.depth, 6);
+    EXPECT_FALSE(rm.stopped);
+  }
+
+  // prazo: interrompida pelo relógio, não por stop()
+  const auto t0 = std::chrono::steady_clock::now();
+  const SearchResult r3 = deep.start_search(big, SearchLimits{40, 0, 50, 3}).wait();
+  EXPECT_TRUE(r3.stopped);
+  EXPECT_GE(r3.depth, 1);
+  EXPECT_LT(std::chrono::steady_clock::now() - t0, std::chrono::seconds(2));
+}
+
+// Relógio: o orçamento acompanha o tempo restante e as jogadas que faltam;
+// com soft/hard a procura pára dentro do teto com uma iteração completa
+TEST(TimeManager, BudgetFollowsClockAndStopsSearch) {
+  EXPECT_EQ(TimeManager::scheduled_depth(3, 9, 0), 3);
+  EXPECT_EQ(TimeManager::scheduled_depth(3, 9, 10), 5);   // 3 + 2 = 5
+  EXPECT_EQ(TimeManager::scheduled_depth(3, 9, 15), 5);   // 6 -> ímpar
+  EXPECT_EQ(TimeManager::scheduled_depth(3, 9, 100), 9);
+
+  TimeManager off;
+  EXPECT_FALSE(off.enabled());
+  EXPECT_EQ(off.allocate(Board(7, 7)).soft_ms, 0);
+
+  Board open(9, 9);
+  TimeManager tm(TimeControl{10000, 100});
+  const auto b = tm.allocate(open);
+  EXPECT_GT(b.soft_ms, 0);
+  EXPECT_GE(b.hard_ms, b.soft_ms);
+  EXPECT_LE(b.hard_ms, 10000 / 2 + 100);
+  // menos tempo no relógio -> menos por jogada
+  TimeManager low(TimeControl{1000, 0});
+  EXPECT_LT(low.allocate(open).soft_ms, b.soft_ms);
+
+  tm.consume(400);
+  EXPECT_EQ(tm.remaining_ms(), 10000 - 400 + 100);
+  TimeManager flag(TimeControl{100, 50});
+  flag.consume(150);
+  EXPECT_TRUE(flag.flagged());
+
+  // a procura com orçamento termina bem antes do teto de profundidade
+  AI ai(open.current_player_is_max(), 40);
+  ai.set_time_budget(30, 120);
+  const auto t0 = std::chrono::steady_clock::now();
+  const auto mv = ai.choose_move(open, 40, 3);
+  const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - t0).count();
+  EXPECT_GE(ai.last_completed_depth(), 1);
+  EXPECT_LT(ai.last_completed_depth(), 40);
+  EXPECT_LT(ms, 1000);
+  const auto legal = open.get_valid_moves();
+  EXPECT_NE(std::find(legal.begin(), legal.end(), mv), legal.end());
+}
+
+// Calibração: a profundidade cresce com a velocidade medida e o resultado
+// fica em calibration.txt (a 2ª consulta lê o ficheiro, não volta a medir)
+TEST(Calibration, DepthFromRateAndDiskCache) {
+  Calibration slow;
+  slow.nps = 1e4;
+  slow.ebf = 4.0;
+  Calibration fast = slow;
+  fast.nps = 1e7;
+  const auto ls = slow.depth_for(1000), lf = fast.depth_for(1000);
+  EXPECT_EQ(ls.max_depth % 2, 1);
+  EXPECT_EQ(lf.max_depth % 2, 1);
+  EXPECT_GT(lf.max_depth, ls.max_depth);
+  EXPECT_LE(lf.start_depth, lf.max_depth);
+  EXPECT_LE(slow.time_for_depth(ls.max_depth), 1000);
+  EXPECT_FALSE(Calibration{}.valid());
+
+  const std::string dir = ::testing::TempDir() + "/calib";
+  std::filesystem::create_directories(dir);
+  std::filesystem::remove(dir + "/calibration.txt");
+  // repor no fim: os testes seguintes leem os dados de RASTROS_DATA_DIR
+  const char* prev = std::getenv("RASTROS_DATA_DIR");
+  const std::string saved = prev ? prev : "";
+  ASSERT_EQ(setenv("RASTROS_DATA_DIR", dir.c_str(), 1), 0);
+  const Calibration m = Calibration::measure(6, 6, /*bench_ms=*/50);
+  EXPECT_TRUE(m.valid());
+  {
+    std::ofstream out(Calibration::default_path());
+    out << "6 7 12345 3.5\n";
+  }
+  const Calibration cached = Calibration::for_size(6, 7);
+  EXPECT_DOUBLE_EQ(cached.nps, 12345);
+  EXPECT_DOUBLE_EQ(cached.ebf, 3.5);
+
+  if (prev) setenv("RASTROS_DATA_DIR", saved.c_str(), 1);
+  else      unsetenv("RASTROS_DATA_DIR");
+}
+
+// Extensões: a derrota forçada que a profundidade 3 não vê (e a 7 confirma)
+// aparece a 3 com extensões; sem orçamento o resultado é o da procura normal
+TEST(Extensions, FindForcedLossEarlierWithinBudget) {
+  Board b(7, 7);
+  const std::vector<Board::Move> seq = {
+      {3, 3}, {3, 4}, {3, 5}, {4, 6}, {5, 6}, {6, 6}, {5, 5}, {4, 4},
+      {4, 3}, {5, 3}, {6, 3}, {6, 4}, {6, 5}, {5, 4}, {4, 5}, {3, 6}};
+  for (const auto& mv : seq) b.apply_move(mv);
+  ASSERT_FALSE(b.is_terminal());
+  const bool mx = b.current_player_is_max();
+
+  auto search = [&](int depth, bool ext, int budget) {
+    AI ai(mx, depth);
+    ai.set_extensions(ext, budget);
+    Board tmp = b;
+    ai.choose_move(tmp, depth, 10);
+    return ai.last_score();
+  };
+  const int deep = search(7, false, 0);
+  ASSERT_LE(deep, -RaceBounds::kHeuristicBound);
+  EXPECT_GT(search(3, false, 0), -RaceBounds::kHeuristicBound);
+  EXPECT_EQ(search(3, true, AI::kDefaultExtensionBudget), deep);
+  EXPECT_EQ(search(3, true, 0), search(3, false, 0));
+}
+
+// Estado por AI: jogos em threads paralelas dão as mesmas jogadas que em
+// série; as caches de uma AI não mudam as de outra salvo partilha explícita
+TEST(SearchContext, ConcurrentGamesMatchSequentialAndNoCrossTalk) {
+  auto play = [](uint64_t seed) {
+    Board b(7, 7);
+    AI p1(true, 5), p2(false, 5);
+    for (AI* ai : {&p1, &p2}) ai->set_seed(seed);
+    std::vector<Board::Move> moves;
+    for (int round = 1; !b.is_terminal() && round < 60; ++round) {
+      AI& ai = b.current_player_is_max() ? p1 : p2;
+      const auto mv = ai.choose_move(b, 5, round);
+      b.apply_move(mv);
+      moves.push_back(mv);
+    }
+    return moves;
+  };
+  const auto seq_a = play(1), seq_b = play(2);
+  std::vector<Board::Move> par_a, par_b;
+  std::thread ta([&] { par_a = play(1); });
+  std::thread tb([&] { par_b = play(2); });
+  ta.join();
+  tb.join();
+  EXPECT_EQ(par_a, seq_a);
+  EXPECT_EQ(par_b, seq_b);
+
+  Board b(7, 7);
+  b.apply_move(b.get_valid_moves().front());
+  const bool mx = b.current_player_is_max();
+  AI a(mx, 5), other(mx, 5);
+  a.choose_move(b, 5, 1);
+  const uint64_t lookups = a.search_context().vs_lookups;
+  EXPECT_GT(lookups, 0u);
+  other.choose_move(b, 5, 1);
+  EXPECT_EQ(a.search_context().vs_lookups, lookups);
+  EXPECT_EQ(a.rounds(), 1);
+
+  AI copy = a;   // cópia: contexto próprio
+  copy.choose_move(b, 5, 2);
+  EXPECT_EQ(a.search_context().vs_lookups, lookups);
+  other.share_search_context(a);
+  other.choose_move(b, 5, 3);
+  EXPECT_GT(a.search_context().vs_lookups, lookups);
+  EXPECT_EQ(a.rounds(), 3);
+}
+
+TEST(SearchArena, ScratchStaysInArenaAndIsReused) {
+  EXPECT_EQ(SearchArena::current(), std::pmr::new_delete_resource());
+
+  SearchArena arena(1024);
+  {
+    SearchArena::Scope scope(arena);
+    EXPECT_EQ(SearchArena::current(), &arena);
+    const auto before = arena.mark();
+    {
+      SearchArena::Frame frame;
+      std::pmr::vector<int> v(100, 0, SearchArena::current());
+      EXPECT_GT(arena.mark().offset, before.offset);
+    }
+    EXPECT_EQ(arena.mark().offset, before.offset);
+  }
+  EXPECT_EQ(SearchArena::current(), std::pmr::new_delete_resource());
+
+  // compute_distance igual dentro e fora de uma procura
+  Board b(7, 7);
+  b.apply_move(b.get_valid_moves().front());
+  const auto outside = b.compute_distance();
+  {
+    SearchArena::Scope scope(arena);
+    const auto inside = b.compute_distance();
+    EXPECT_EQ(inside.h1, outside.h1);
+    EXPECT_EQ(inside.h5, outside.h5);
+    EXPECT_EQ(inside.reachable_count, outside.reachable_count);
+  }
+
+  // a procura usa a arena do seu contexto; a segunda não reserva mais blocos
+  const bool mx = b.current_player_is_max();
+  AI ai(mx, 5);
+  ai.choose_move(b, 5, 1);
+  const SearchArena& used = ai.search_context().arena;
+  EXPECT_GT(used.high_water(), 0u);
+  const std::size_t cap = used.capacity();
+  ai.choose_move(b, 5, 2);
+  EXPECT_EQ(used.capacity(), cap);
+}
@@ -0,0 +1,44 @@
+// ============================================================================
+// build_opening_book.cpp — Gerador offline do livro de aberturas
+// ----------------------------------------------------------------------------
+// Uso: RastrosOpeningBook <rows> <cols> [plies] [depth] [threads] [ficheiro]
+//   Procura todas as posições a 1..plies do início de Board(rows, cols)
+//   (reduzidas por simetria) à profundidade 'depth', em paralelo, e grava o
+//   ficheiro lido por OpeningBook (por defeito em data/book_RxC.rbk).
+//   Defaults: plies 4, depth 9, threads = nº de núcleos.
+// ============================================================================
+
+#include "OpeningBook.hpp"
+#include "AI.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Uso: " << argv[0] << " <rows> <cols> [plies] [depth] [threads] [ficheiro]\n";
+        return 1;
+    }
+    const int rows = std::stoi(argv[1]);
+    const int cols = std::stoi(argv[2]);
+    const int plies = (argc > 3) ? std::stoi(argv[3]) : 4;
+    const int depth = (argc > 4) ? std::stoi(argv[4]) : 9;
+    const int threads = (argc > 5) ? std::stoi(argv[5])
+                                   : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const std::string path = (argc > 6) ? argv[6] : OpeningBook::default_path(rows, cols);
+
+    AI::register_heuristics();
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t enumerated = 0;
+    uint64_t n = OpeningBook::build(rows, cols, plies, depth, threads, path, &enumerated);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (n == 0) {
+        std::cerr << "Erro ao gerar " << path << "\n";
+        return 1;
+    }
+    std::cout << rows << "x" << cols << ": " << n << " posições (" << enumerated
+              << " antes das simetrias), " << plies << " plies a profundidade " << depth
+              << ", " << threads << " threads, " << secs << " s -> " << path << "\n";
+    return 0;
+}
@@ -0,0 +1,44 @@
+// ============================================================================
+// build_perfect_db.cpp — Gerador offline da base de dados de jogo perfeito
+// ----------------------------------------------------------------------------
+// Uso: RastrosPerfectDB <rows> <cols> [ficheiro]
+//   Resolve todas as posições alcançáveis a partir de Board(rows, cols) e grava
+//   o ficheiro lido por PerfectPlayDB (por defeito em data/perfect_RxC.rpdb).
+//   5x5 resolve-se em segundos; 6x6 exige bastante mais tempo e memória.
+// ============================================================================
+
+#include "PerfectPlayDB.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Uso: " << argv[0] << " <rows> <cols> [ficheiro]\n";
+        return 1;
+    }
+    const int rows = std::stoi(argv[1]);
+    const int cols = std::stoi(argv[2]);
+    if (!PerfectPlayDB::supports(rows, cols)) {
+        std::cerr << "Tamanho não suportado (máximo 49 células).\n";
+        return 1;
+    }
+    const std::string path = (argc > 3) ? argv[3] : PerfectPlayDB::default_path(rows, cols);
+
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t n = PerfectPlayDB::build(rows, cols, path);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (n == 0) {
+        std::cerr << "Erro ao gerar " << path << "\n";
+        return 1;
+    }
+
+    PerfectPlayDB db;
+    db.open(path);
+    Board start(rows, cols);
+    auto res = db.probe(start, start.current_player_is_max());
+    std::cout << rows << "x" << cols << ": " << n << " posições em " << secs << " s -> " << path
+              << " (início: " << (res == PerfectPlayDB::Result::Win ? "vitória" : "derrota")
+              << " para o Jogador 1)\n";
+    return 0;
+}